@@ -3,6 +3,9 @@
 #include "player.h"
 #include "scene.h"
 #include "loaders.h"
+#include "profiler.h"
+#include "perfcounters.h"
+#include "allocationcounter.h"
 
 #include <SFML/Graphics.hpp>
 #include <SFML/Graphics/Font.hpp>
@@ -27,6 +30,12 @@ Game::Game()
     logManager.addLogger(make_shared<soul::LoggerGui>(soul::LOG_LEVEL::LOG_DEBUG, guiDebugLog));
 #endif
 
+    _guiLatency = std::make_shared<soul::GuiLatency>();
+    _guiLatency->addSeries("Frame", _frameTimes);
+    _guiLatency->addSeries("Update", _updateTimes);
+    _guiLatency->addSeries("Render", _renderTimes);
+    _guiPerformance = std::make_shared<soul::GuiPerformance>();
+
     const std::string configPath = pathManager.getFilePath(soul::PathManager::FileType::Config, _configFile)->string();
     std::ifstream file(configPath);
     json data;
@@ -52,9 +61,15 @@ Game::~Game() {}
 int Game::run() {
     sf::Clock deltaClock;
     auto lastTime = std::chrono::high_resolution_clock::now();
+    soul::Profiler& profiler = soul::Profiler::getInstance();
+    soul::PerfCounters& perfCounters = soul::PerfCounters::getInstance();
 
     // Main game loop
     while (_gw.window.isOpen()) {
+        // Statistics of the previous frame, its zones are all closed here
+        profiler.endFrame();
+        perfCounters.endFrame();
+        SOUL_PROFILE_SCOPE("Game::frame");
 
         while (const std::optional event = _gw.window.pollEvent()) {
 
@@ -88,6 +103,12 @@ int Game::run() {
                     case sf::Keyboard::Scancode::D: _scene->player->input.defensive = true; break;
                     case sf::Keyboard::Scancode::Q: _scene->player->input.knockedout = true; break;
 
+                    case sf::Keyboard::Scancode::F8: _dumpFrameGraph(); break;
+                    // Start/stop a profiler capture, written as a Chrome trace when it stops
+                    case sf::Keyboard::Scancode::F9: _toggleProfilerCapture(); break;
+                    case sf::Keyboard::Scancode::F10: _showLatency = !_showLatency; break;
+                    case sf::Keyboard::Scancode::F11: _showPerformance = !_showPerformance; break;
+
                     default: break;
                 }
             }
@@ -117,18 +138,44 @@ int Game::run() {
 
         auto currentTime = std::chrono::high_resolution_clock::now();
         float dt = std::chrono::duration<float>(currentTime - lastTime).count();
+        _frameTimes.record(currentTime - lastTime);
         lastTime = currentTime;
 
         ImGui::SFML::Update(_gw.window, sf::seconds(dt));
 
         // auto localdt = deltaClock.getElapsedTime().asSeconds();
 
+        soul::st_time_elapsed<soul::TscClock> elapsed;
+        elapsed.start();
         _scene->update(dt);
+        const std::chrono::nanoseconds updateTime = elapsed.elapsed();
+        _updateTimes.record(updateTime);
 
         // Clear the window
         _gw.window.clear(sf::Color(50, 50, 50, 0));
 
+        elapsed.start();
         _scene->render();
+        const std::chrono::nanoseconds renderTime = elapsed.elapsed();
+        _renderTimes.record(renderTime);
+
+        const uint64_t allocations = soul::AllocationCounter::getAllocations();
+        _guiPerformance->addSample(soul::PerformanceSample{
+            dt * 1000.0f,
+            std::chrono::duration<float, std::milli>(updateTime).count(),
+            std::chrono::duration<float, std::milli>(renderTime).count(),
+            _gw.getDrawCalls(),
+            allocations - _lastAllocations,
+            _scene->entities.getTotalEntities()});
+        _lastAllocations = allocations;
+        _gw.resetDrawCalls();
+
+        if (_showLatency) {
+            _guiLatency->render(_gw);
+        }
+        if (_showPerformance) {
+            _guiPerformance->render(_gw);
+        }
 
 #ifdef DEBUGMODE
         guiDebugLog_->render(gw_);
@@ -138,14 +185,45 @@ int Game::run() {
 
         ImGui::SFML::Render(_gw.window);
 
-        // Display what has been drawn
-        _gw.window.display();
+        {
+            // Display what has been drawn, includes the wait for the frame limit
+            SOUL_PROFILE_SCOPE("Game::display");
+            _gw.window.display();
+        }
 
         // Sleep to control frame rate (for demonstration)
         // std::this_thread::sleep_for(std::chrono::milliseconds(16)); // Cap at ~60 FPS
     }
 
+    // Last frame
+    profiler.endFrame();
+    if (profiler.isCapturing()) {
+        _toggleProfilerCapture();
+    }
+
     ImGui::SFML::Shutdown();
 
     return 0;
 }
+
+void Game::_toggleProfilerCapture() {
+    soul::Profiler& profiler = soul::Profiler::getInstance();
+    auto& logManager = soul::LoggerManager::getInstance();
+
+    if (!profiler.isCapturing()) {
+        profiler.beginCapture();
+        logManager.logInfo("Profiler capture started");
+        return;
+    }
+
+    profiler.endCapture();
+    profiler.writeChromeTrace(_traceFile);
+    logManager.logInfo("Profiler capture of {} zones written to {}", profiler.getCaptureSize(), _traceFile);
+}
+
+void Game::_dumpFrameGraph() {
+    auto& logManager = soul::LoggerManager::getInstance();
+
+    _scene->frameGraph.writeDot(_frameGraphFile);
+    logManager.logInfo("Frame graph of {} systems written to {}", _scene->frameGraph.size(), _frameGraphFile);
+}
@@ -36,6 +36,21 @@ private:
     std::unique_ptr<soul::Scene> _scene;
     // Config file
     const std::string _configFile = "config.json";
+    // Chrome trace_event file written by a profiler capture (F9)
+    const std::string _traceFile = "goku_trace.json";
+    // Graphviz dump of the frame graph of the scene with its last timings (F8)
+    const std::string _frameGraphFile = "goku_framegraph.dot";
+
+    // Tail latency of the game loop, shown in the Latency window (F10)
+    soul::LatencyHistogram _frameTimes;
+    soul::LatencyHistogram _updateTimes;
+    soul::LatencyHistogram _renderTimes;
+    std::shared_ptr<soul::GuiLatency> _guiLatency;
+    bool _showLatency {true};
+    // Rolling graphs of the frame, Performance window (F11)
+    std::shared_ptr<soul::GuiPerformance> _guiPerformance;
+    bool _showPerformance {true};
+    uint64_t _lastAllocations {0};
 
 #ifdef DEBUGMODE
     std::shared_ptr<soul::GuiAnimableStates> _guiStates;
@@ -53,6 +68,14 @@ public:
 
     _ALWAYS_INLINE_ bool isRunning() const { return _running; }
 
+private:
+    // Start or stop the profiler capture
+    void _toggleProfilerCapture();
+    // Write the frame graph of the scene
+    void _dumpFrameGraph();
+
+public:
+
     // Singleton
     static Game& getInstance()
     {
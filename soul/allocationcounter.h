@@ -0,0 +1,26 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace soul {
+
+/**
+ * @brief Process-wide count of the heap allocations.
+ * The counters are only incremented when the executable replaces the global
+ * operator new (see game/allocations.cpp), otherwise they stay at 0.
+ */
+struct AllocationCounter {
+    static inline std::atomic<uint64_t> allocations {0};
+    static inline std::atomic<uint64_t> bytes {0};
+
+    static void record(size_t size) noexcept {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        bytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    static uint64_t getAllocations() noexcept { return allocations.load(std::memory_order_relaxed); }
+    static uint64_t getBytes() noexcept { return bytes.load(std::memory_order_relaxed); }
+};
+
+} // namespace soul
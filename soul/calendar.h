@@ -0,0 +1,219 @@
+#pragma once
+
+/**
+ * Civil (proleptic Gregorian) calendar arithmetic.
+ * Pure integer arithmetic on serial day numbers (days since 1970-01-01),
+ * without std::mktime/std::localtime and their global timezone lock.
+ * The conversions are the days_from_civil/civil_from_days algorithms
+ * used by std::chrono, interoperable with std::chrono::year_month_day.
+ */
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+namespace soul::calendar {
+
+// Year, month [1, 12] and day [1, 31] of a civil date
+struct CivilDate {
+    int32_t  year {1970};
+    uint32_t month {1};
+    uint32_t day {1};
+
+    constexpr bool operator==(const CivilDate&) const = default;
+};
+
+constexpr bool isLeapYear(int32_t y) noexcept {
+    return (y % 4 == 0) && (y % 100 != 0 || y % 400 == 0);
+}
+
+constexpr uint32_t lastDayOfMonth(int32_t y, uint32_t m) noexcept {
+    constexpr uint8_t days[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (m == 2 && isLeapYear(y)) ? 29u : days[m - 1];
+}
+
+constexpr bool isValid(int32_t y, uint32_t m, uint32_t d) noexcept {
+    return m >= 1 && m <= 12 && d >= 1 && d <= lastDayOfMonth(y, m);
+}
+
+// Serial day number of a civil date, 0 is 1970-01-01
+constexpr int32_t daysFromCivil(int32_t y, uint32_t m, uint32_t d) noexcept {
+    // Years start in March so that the leap day is the last day of the year
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = static_cast<uint32_t>(y - era * 400);                  // [0, 399]
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;       // [0, 365]
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;                 // [0, 146096]
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+constexpr int32_t daysFromCivil(const CivilDate& date) noexcept {
+    return daysFromCivil(date.year, date.month, date.day);
+}
+
+// Civil date of a serial day number
+constexpr CivilDate civilFromDays(int32_t z) noexcept {
+    z += 719468;
+    const int32_t era = (z >= 0 ? z : z - 146096) / 146097;
+    const uint32_t doe = static_cast<uint32_t>(z - era * 146097);                // [0, 146096]
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;  // [0, 399]
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);               // [0, 365]
+    const uint32_t mp = (5 * doy + 2) / 153;                                     // [0, 11]
+    const uint32_t d = doy - (153 * mp + 2) / 5 + 1;                             // [1, 31]
+    const uint32_t m = mp < 10 ? mp + 3 : mp - 9;                                // [1, 12]
+    const int32_t y = static_cast<int32_t>(yoe) + era * 400 + (m <= 2);
+    return CivilDate{y, m, d};
+}
+
+// Day of the week, 0 is Sunday and 6 is Saturday (as std::tm::tm_wday)
+constexpr uint32_t weekdayFromDays(int32_t z) noexcept {
+    // 1970-01-01 was a Thursday
+    return static_cast<uint32_t>(z >= -4 ? (z + 4) % 7 : (z + 5) % 7 + 6);
+}
+
+constexpr bool isWeekend(int32_t z) noexcept {
+    const uint32_t wd = weekdayFromDays(z);
+    return wd == 0 || wd == 6;
+}
+
+// Floor division and modulo, also for negative serial days
+constexpr int32_t floorDiv(int32_t a, int32_t b) noexcept {
+    return (a >= 0 ? a : a - b + 1) / b;
+}
+
+constexpr int32_t floorMod(int32_t a, int32_t b) noexcept {
+    return a - floorDiv(a, b) * b;
+}
+
+// 1970-01-05, the first Monday of the epoch, weekday counts are relative to it
+inline constexpr int32_t FIRST_MONDAY = 4;
+
+// Number of weekdays (Monday to Friday) in [FIRST_MONDAY, z), negative before it
+constexpr int32_t weekdaysBefore(int32_t z) noexcept {
+    const int32_t offset = z - FIRST_MONDAY;
+    const int32_t rest = floorMod(offset, 7);
+    return floorDiv(offset, 7) * 5 + (rest < 5 ? rest : 5);
+}
+
+// Serial day of the weekday with the given count, inverse of weekdaysBefore
+constexpr int32_t nthWeekday(int32_t n) noexcept {
+    return FIRST_MONDAY + floorDiv(n, 5) * 7 + floorMod(n, 5);
+}
+
+// Number of weekdays in [from, to), negative when to < from
+constexpr int32_t weekdaysBetween(int32_t from, int32_t to) noexcept {
+    return weekdaysBefore(to) - weekdaysBefore(from);
+}
+
+// Move n weekdays forward (or backward when negative), 0 leaves z unchanged
+constexpr int32_t addWeekdays(int32_t z, int32_t n) noexcept {
+    if (n > 0)
+        return nthWeekday(weekdaysBefore(z + 1) + n - 1);
+    if (n < 0)
+        return nthWeekday(weekdaysBefore(z) + n);
+    return z;
+}
+
+// Add months, the day is clamped to the end of the resulting month (Jan 31 + 1 month = Feb 28/29)
+constexpr CivilDate addMonths(const CivilDate& date, int32_t months) noexcept {
+    const int32_t index = date.year * 12 + static_cast<int32_t>(date.month) - 1 + months;
+    const int32_t y = (index >= 0 ? index : index - 11) / 12;
+    const uint32_t m = static_cast<uint32_t>(index - y * 12) + 1;
+    const uint32_t last = lastDayOfMonth(y, m);
+    return CivilDate{y, m, date.day < last ? date.day : last};
+}
+
+// Add years, Feb 29 becomes Feb 28 on a common year
+constexpr CivilDate addYears(const CivilDate& date, int32_t years) noexcept {
+    return addMonths(date, years * 12);
+}
+
+// Serial day number of the last day of the month of z
+constexpr int32_t endOfMonth(int32_t z) noexcept {
+    const CivilDate date = civilFromDays(z);
+    return z + static_cast<int32_t>(lastDayOfMonth(date.year, date.month) - date.day);
+}
+
+// Interoperability with std::chrono
+
+constexpr std::chrono::year_month_day toYearMonthDay(const CivilDate& date) noexcept {
+    return std::chrono::year_month_day{
+        std::chrono::year{date.year}, std::chrono::month{date.month}, std::chrono::day{date.day}};
+}
+
+constexpr CivilDate fromYearMonthDay(const std::chrono::year_month_day& ymd) noexcept {
+    return CivilDate{
+        static_cast<int32_t>(ymd.year()), static_cast<unsigned>(ymd.month()), static_cast<unsigned>(ymd.day())};
+}
+
+constexpr std::chrono::sys_days toSysDays(int32_t z) noexcept {
+    return std::chrono::sys_days{std::chrono::days{z}};
+}
+
+namespace detail {
+
+// Offset of the local time from UTC at an instant, asked to the C library
+inline std::chrono::seconds queryUtcOffset(std::chrono::sys_seconds instant) {
+    const std::time_t time = std::chrono::system_clock::to_time_t(instant);
+    std::tm tm = {};
+#if defined(_WIN32)
+    localtime_s(&tm, &time);
+    long seconds = 0;
+    _get_timezone(&seconds);
+    return std::chrono::seconds(-seconds + (tm.tm_isdst > 0 ? 3600 : 0));
+#else
+    localtime_r(&time, &tm);
+    return std::chrono::seconds(tm.tm_gmtoff);
+#endif
+}
+
+} // namespace detail
+
+/**
+ * Offset of the local time from UTC at an instant.
+ * The offset is resolved once per UTC day and cached per thread (by serial day number):
+ * the C library is only asked again for another day, or for each instant of a day
+ * with a daylight saving change. The cache does not follow a change of TZ during the run.
+ */
+inline std::chrono::seconds localUtcOffset(std::chrono::sys_seconds instant) {
+    struct Entry {
+        int32_t day {INT32_MIN};
+        std::chrono::seconds offset {0};
+        // The offset changes during the day
+        bool changes {false};
+    };
+    thread_local std::array<Entry, 64> cache;
+
+    const auto day = std::chrono::floor<std::chrono::days>(instant);
+    const auto serial = static_cast<int32_t>(day.time_since_epoch().count());
+    Entry& entry = cache[static_cast<uint32_t>(serial) % cache.size()];
+    if (entry.day != serial) {
+        const std::chrono::seconds first = detail::queryUtcOffset(day);
+        const std::chrono::seconds last = detail::queryUtcOffset(day + std::chrono::days(1) - std::chrono::seconds(1));
+        entry = Entry{serial, first, first != last};
+    }
+    return entry.changes ? detail::queryUtcOffset(instant) : entry.offset;
+}
+
+/**
+ * Offset of a local time from UTC, such that the instant is local - offset.
+ * A local time skipped by a daylight saving change takes the offset before the change,
+ * a repeated one the offset of one of its two instants.
+ */
+inline std::chrono::seconds localUtcOffset(std::chrono::local_seconds local) {
+    const std::chrono::sys_seconds guess {local.time_since_epoch()};
+    return localUtcOffset(guess - localUtcOffset(guess));
+}
+
+static_assert(daysFromCivil(1970, 1, 1) == 0);
+static_assert(daysFromCivil(2000, 3, 1) == 11017);
+static_assert(civilFromDays(-1) == CivilDate{1969, 12, 31});
+static_assert(weekdayFromDays(0) == 4);
+static_assert(addMonths(CivilDate{2024, 1, 31}, 1) == CivilDate{2024, 2, 29});
+static_assert(addMonths(CivilDate{2024, 1, 15}, -13) == CivilDate{2022, 12, 15});
+static_assert(weekdayFromDays(FIRST_MONDAY) == 1);
+static_assert(addWeekdays(daysFromCivil(2024, 5, 3), 1) == daysFromCivil(2024, 5, 6));
+static_assert(addWeekdays(daysFromCivil(2024, 5, 4), -1) == daysFromCivil(2024, 5, 3));
+
+} // namespace soul::calendar
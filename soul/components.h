@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace soul::ecs {
+
+// Position in pixels, rotation in degrees
+struct Transform {
+    float x {0.0f};
+    float y {0.0f};
+    float rotation {0.0f};
+    float scale {1.0f};
+};
+
+// Pixels per second
+struct Velocity {
+    float dx {0.0f};
+    float dy {0.0f};
+};
+
+// Texture rect in the sprite sheet, in pixels
+struct Sprite {
+    uint32_t texture {0};
+    float u {0.0f};
+    float v {0.0f};
+    float width {0.0f};
+    float height {0.0f};
+};
+
+// Frames laid out horizontally in the sheet from originU, frame i at originU + i * Sprite::width
+struct Animation {
+    float originU {0.0f};
+    float frameTime {0.1f};
+    float elapsed {0.0f};
+    uint16_t frame {0};
+    uint16_t frameCount {1};
+};
+
+// Seconds left before the entity is destroyed
+struct Lifetime {
+    float remaining {0.0f};
+};
+
+// Box centered on the transform, layer and mask select what it collides with
+struct Collider {
+    float halfWidth {0.0f};
+    float halfHeight {0.0f};
+    uint32_t layer {1};
+    uint32_t mask {~0u};
+};
+
+template<typename... Ts>
+struct TypeList {};
+
+// Every component type, its position is its id
+using Components = TypeList<Transform, Velocity, Sprite, Animation, Lifetime, Collider>;
+
+// Bit per component id
+using ComponentMask = uint32_t;
+
+namespace detail {
+
+template<typename T, typename List>
+struct IndexOf;
+
+template<typename T, typename... Ts>
+struct IndexOf<T, TypeList<T, Ts...>> : std::integral_constant<uint32_t, 0> {};
+
+template<typename T, typename U, typename... Ts>
+struct IndexOf<T, TypeList<U, Ts...>> : std::integral_constant<uint32_t, 1 + IndexOf<T, TypeList<Ts...>>::value> {};
+
+template<typename... Ts>
+constexpr auto sizesOf(TypeList<Ts...>) {
+    static_assert((std::is_trivially_copyable_v<Ts> && ...), "Components are moved between chunks with memcpy");
+    return std::array<size_t, sizeof...(Ts)> {sizeof(Ts)...};
+}
+
+} // namespace detail
+
+inline constexpr auto COMPONENT_SIZES = detail::sizesOf(Components {});
+
+inline constexpr uint32_t COMPONENT_COUNT = static_cast<uint32_t>(COMPONENT_SIZES.size());
+
+static_assert(COMPONENT_COUNT <= 32, "ComponentMask has one bit per component");
+
+template<typename T>
+constexpr uint32_t componentId() {
+    return detail::IndexOf<std::remove_cv_t<T>, Components>::value;
+}
+
+template<typename... Cs>
+constexpr ComponentMask maskOf() {
+    return ((ComponentMask(1) << componentId<Cs>()) | ... | ComponentMask(0));
+}
+
+} // namespace soul::ecs
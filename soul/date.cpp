@@ -0,0 +1,120 @@
+#include "date.h"
+#include "datetime.h"
+
+#include <stdexcept>
+
+using namespace soul;
+
+Date Date::fromDateTime(const DateTime& dt) {
+    return Date(dt.localDays());
+}
+
+DateTime Date::toDateTime() const {
+    return DateTime::fromLocalDays(days);
+}
+
+namespace {
+
+// Eras of 400 years added to the serial day so that the batch arithmetic is unsigned:
+// no sign branches and divisions by constants the compiler turns into vector multiplications.
+constexpr uint32_t ERA_BIAS = 100;
+constexpr uint32_t DAYS_BIAS = 719468 + ERA_BIAS * 146097;
+
+static_assert((DAYS_BIAS + 3) % 7 == 4);
+
+struct CivilParts {
+    int32_t  year;
+    uint32_t month;
+    uint32_t day;
+    uint32_t doy;  // Day of the year starting in March
+    uint32_t mp;   // Month starting in March, [0, 11]
+};
+
+// calendar::civilFromDays without branches
+inline CivilParts civilParts(int32_t z) {
+    const uint32_t u = static_cast<uint32_t>(z) + DAYS_BIAS;
+    const uint32_t era = u / 146097;
+    const uint32_t doe = u - era * 146097;
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    const uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+    const uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    const int32_t y = static_cast<int32_t>(yoe + (era - ERA_BIAS) * 400 + (m <= 2));
+    return CivilParts{y, m, d, doy, mp};
+}
+
+void checkSize(size_t input, size_t output) {
+    if (output < input) {
+        throw std::invalid_argument("Output column smaller than the input dates");
+    }
+}
+
+} // namespace
+
+void dates::addDays(std::span<Date> dates, int32_t n) {
+    Date* data = dates.data();
+    const size_t size = dates.size();
+    for (size_t i = 0; i < size; ++i)
+        data[i].days += n;
+}
+
+void dates::weekday(std::span<const Date> dates, std::span<uint8_t> weekdays) {
+    checkSize(dates.size(), weekdays.size());
+    const Date* data = dates.data();
+    uint8_t* out = weekdays.data();
+    const size_t size = dates.size();
+    for (size_t i = 0; i < size; ++i) {
+        // 1970-01-01 was a Thursday (4), DAYS_BIAS + 3 keeps that offset modulo 7
+        out[i] = static_cast<uint8_t>((static_cast<uint32_t>(data[i].days) + DAYS_BIAS + 3) % 7);
+    }
+}
+
+void dates::endOfMonth(std::span<const Date> dates, std::span<Date> ends) {
+    checkSize(dates.size(), ends.size());
+    const Date* data = dates.data();
+    Date* out = ends.data();
+    const size_t size = dates.size();
+    for (size_t i = 0; i < size; ++i) {
+        const int32_t z = data[i].days;
+        const CivilParts c = civilParts(z);
+        // Months from March to January end the day before the next month starts,
+        // February (the last month of a year starting in March) ends on the 28th or 29th
+        const int32_t next = static_cast<int32_t>((153 * (c.mp + 1) + 2) / 5);
+        const int32_t leap = (c.year % 4 == 0) & ((c.year % 100 != 0) | (c.year % 400 == 0));
+        const int32_t marchToJanuary = z - static_cast<int32_t>(c.doy) + next - 1;
+        const int32_t february = z - static_cast<int32_t>(c.day) + 28 + leap;
+        out[i].days = c.mp == 11 ? february : marchToJanuary;
+    }
+}
+
+void dates::yearMonth(std::span<const Date> dates, std::span<int32_t> years, std::span<uint8_t> months) {
+    checkSize(dates.size(), years.size());
+    checkSize(dates.size(), months.size());
+    const Date* data = dates.data();
+    int32_t* outYears = years.data();
+    uint8_t* outMonths = months.data();
+    const size_t size = dates.size();
+    for (size_t i = 0; i < size; ++i) {
+        const CivilParts c = civilParts(data[i].days);
+        outYears[i] = c.year;
+        outMonths[i] = static_cast<uint8_t>(c.month);
+    }
+}
+
+void dates::toCivil(std::span<const Date> dates, std::span<int32_t> years, std::span<uint8_t> months, std::span<uint8_t> days) {
+    checkSize(dates.size(), years.size());
+    checkSize(dates.size(), months.size());
+    checkSize(dates.size(), days.size());
+    const Date* data = dates.data();
+    int32_t* outYears = years.data();
+    uint8_t* outMonths = months.data();
+    uint8_t* outDays = days.data();
+    const size_t size = dates.size();
+    for (size_t i = 0; i < size; ++i) {
+        const CivilParts c = civilParts(data[i].days);
+        outYears[i] = c.year;
+        outMonths[i] = static_cast<uint8_t>(c.month);
+        outDays[i] = static_cast<uint8_t>(c.day);
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#include "calendar.h"
+
+namespace soul {
+
+class DateTime;
+
+/**
+ * @brief Calendar date stored as a 32-bit serial day number (days since 1970-01-01).
+ * Trivially copyable and 4 bytes, arrays of dates are dense columns that the batch
+ * functions below process in branch-free loops the compiler can vectorize.
+ * Supported years are [-32767, 32767], as std::chrono::year.
+ */
+struct Date {
+    int32_t days {0};
+
+    constexpr Date() = default;
+    constexpr explicit Date(int32_t serial) : days(serial) {}
+    constexpr Date(int32_t year, uint32_t month, uint32_t day) : days(calendar::daysFromCivil(year, month, day)) {}
+    constexpr explicit Date(const calendar::CivilDate& date) : days(calendar::daysFromCivil(date)) {}
+
+    // Local date of a DateTime, and midnight local time of this date
+    static Date fromDateTime(const DateTime& dt);
+    DateTime toDateTime() const;
+
+    constexpr calendar::CivilDate civil() const { return calendar::civilFromDays(days); }
+    constexpr int32_t year() const { return civil().year; }
+    constexpr uint32_t month() const { return civil().month; }
+    constexpr uint32_t day() const { return civil().day; }
+
+    // 0 is Sunday and 6 is Saturday
+    constexpr uint32_t weekday() const { return calendar::weekdayFromDays(days); }
+    constexpr bool isWeekend() const { return calendar::isWeekend(days); }
+
+    constexpr Date endOfMonth() const { return Date(calendar::endOfMonth(days)); }
+    constexpr Date addMonths(int32_t months) const { return Date(calendar::addMonths(civil(), months)); }
+    constexpr Date addYears(int32_t years) const { return Date(calendar::addYears(civil(), years)); }
+
+    constexpr Date operator+(int32_t n) const { return Date(days + n); }
+    constexpr Date operator-(int32_t n) const { return Date(days - n); }
+    constexpr int32_t operator-(Date other) const { return days - other.days; }
+    constexpr Date& operator+=(int32_t n) { days += n; return *this; }
+    constexpr Date& operator-=(int32_t n) { days -= n; return *this; }
+
+    constexpr auto operator<=>(const Date&) const = default;
+};
+
+static_assert(sizeof(Date) == 4);
+static_assert(std::is_trivially_copyable_v<Date>);
+
+/**
+ * Batch operations over date columns.
+ * The output spans must be at least as long as the input, otherwise std::invalid_argument is thrown.
+ */
+namespace dates {
+
+void addDays(std::span<Date> dates, int32_t n);
+
+// 0 is Sunday and 6 is Saturday
+void weekday(std::span<const Date> dates, std::span<uint8_t> weekdays);
+
+void endOfMonth(std::span<const Date> dates, std::span<Date> ends);
+
+void yearMonth(std::span<const Date> dates, std::span<int32_t> years, std::span<uint8_t> months);
+
+// Split into year, month and day columns
+void toCivil(std::span<const Date> dates, std::span<int32_t> years, std::span<uint8_t> months, std::span<uint8_t> days);
+
+} // namespace dates
+
+} // namespace soul
@@ -1,6 +1,10 @@
 
 #include "datetime.h"
 
+#include <bit>
+#include <charconv>
+#include <cstring>
+
 using namespace soul;
 
 void DateTime::addSeconds(int seconds) {
@@ -20,10 +24,9 @@ void DateTime::subtractDays(int days) {
 }
 
 void DateTime::addMonths(int months) {
-    std::tm tm = toTm();
-    tm.tm_mon += months;
-    normalizeTm(tm);
-    updateFromTm(tm);
+    const auto [days, time] = toLocal();
+    const auto date = calendar::addMonths(calendar::civilFromDays(days), months);
+    time_point_ = fromLocal(calendar::daysFromCivil(date), time);
 }
 
 void DateTime::subtractMonths(int months) {
@@ -31,10 +34,9 @@ void DateTime::subtractMonths(int months) {
 }
 
 void DateTime::addYears(int years) {
-    std::tm tm = toTm();
-    tm.tm_year += years;
-    normalizeTm(tm);
-    updateFromTm(tm);
+    const auto [days, time] = toLocal();
+    const auto date = calendar::addYears(calendar::civilFromDays(days), years);
+    time_point_ = fromLocal(calendar::daysFromCivil(date), time);
 }
 
 void DateTime::subtractYears(int years) {
@@ -42,24 +44,277 @@ void DateTime::subtractYears(int years) {
 }
 
 void DateTime::addBusinessDays(int days) {
-    while (days > 0) {
-        addDays(1);
-        if (isBusinessDay()) {
-            --days;
+    const auto [local, time] = toLocal();
+    time_point_ = fromLocal(calendar::addWeekdays(local, days), time);
+}
+
+void DateTime::subtractBusinessDays(int days) {
+    addBusinessDays(-days);
+}
+
+bool DateTime::isBusinessDay() const {
+    return !calendar::isWeekend(toLocal().first);
+}
+
+void DateTime::addBusinessDays(int days, const HolidayCalendar& holidays) {
+    const auto [local, time] = toLocal();
+    time_point_ = fromLocal(holidays.addBusinessDays(local, days), time);
+}
+
+void DateTime::subtractBusinessDays(int days, const HolidayCalendar& holidays) {
+    addBusinessDays(-days, holidays);
+}
+
+bool DateTime::isBusinessDay(const HolidayCalendar& holidays) const {
+    return holidays.isBusinessDay(toLocal().first);
+}
+
+void DateTime::roll(RollConvention convention, const HolidayCalendar& holidays) {
+    const auto [local, time] = toLocal();
+    time_point_ = fromLocal(holidays.adjust(local, convention), time);
+}
+
+int DateTime::businessDaysUntil(const DateTime& other, const HolidayCalendar& holidays) const {
+    return holidays.businessDaysBetween(toLocal().first, other.toLocal().first);
+}
+
+namespace {
+
+bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+uint32_t digits2(const char* p) {
+    return static_cast<uint32_t>(p[0] - '0') * 10 + static_cast<uint32_t>(p[1] - '0');
+}
+
+// Pattern of 8 characters: 'd' is a digit, '?' is not checked, anything else must match exactly
+constexpr uint64_t patternBytes(std::string_view pattern, bool digits) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        if ((pattern[i] == 'd') == digits && pattern[i] != '?')
+            mask |= uint64_t(0xFF) << (8 * i);
+    }
+    return mask;
+}
+
+constexpr uint64_t patternValue(std::string_view pattern) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < 8; ++i) {
+        if (pattern[i] != 'd' && pattern[i] != '?')
+            value |= uint64_t(static_cast<uint8_t>(pattern[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * Validates 8 characters at once (SWAR): the separators are compared with one mask,
+ * the digits are checked with the carry trick of 0x06 added to every byte,
+ * which only stays in the 0x30 row for '0' to '9'.
+ */
+template<uint64_t DIGITS, uint64_t SEPARATORS, uint64_t VALUE>
+bool matches8(const char* p) {
+    if constexpr (std::endian::native == std::endian::little) {
+        uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+        if ((word & SEPARATORS) != VALUE)
+            return false;
+
+        constexpr uint64_t ZEROS = 0x3030303030303030ull;
+        constexpr uint64_t HIGH = 0xF0F0F0F0F0F0F0F0ull;
+        const uint64_t value = (word & DIGITS) | (ZEROS & ~DIGITS);
+        return ((value & HIGH) | (((value + 0x0606060606060606ull) & HIGH) >> 4)) == 0x3333333333333333ull;
+    } else {
+        for (size_t i = 0; i < 8; ++i) {
+            const uint64_t shift = 8 * i;
+            if (((DIGITS >> shift) & 0xFF) && !isDigit(p[i]))
+                return false;
+            if (((SEPARATORS >> shift) & 0xFF) && static_cast<uint8_t>(p[i]) != ((VALUE >> shift) & 0xFF))
+                return false;
         }
+        return true;
     }
 }
 
-void DateTime::subtractBusinessDays(int days) {
-    while (days > 0) {
-        subtractDays(1);
-        if (isBusinessDay()) {
-            --days;
+#define SOUL_MATCHES8(p, pattern) \
+    matches8<patternBytes(pattern, true), patternBytes(pattern, false), patternValue(pattern)>(p)
+
+char* writeDigits2(char* out, uint32_t value) {
+    out[0] = static_cast<char>('0' + value / 10);
+    out[1] = static_cast<char>('0' + value % 10);
+    return out + 2;
+}
+
+char* writeYear(char* out, int32_t year) {
+    if (year >= 0 && year <= 9999) {
+        out = writeDigits2(out, static_cast<uint32_t>(year) / 100);
+        return writeDigits2(out, static_cast<uint32_t>(year) % 100);
+    }
+    // Years out of the ISO range, 12 characters are enough for any int32_t
+    return std::to_chars(out, out + 12, year).ptr;
+}
+
+} // namespace
+
+char* DateTime::formatDateTo(char* out) const {
+    const calendar::CivilDate date = civilDate();
+    out = writeYear(out, date.year);
+    *out++ = '-';
+    out = writeDigits2(out, date.month);
+    *out++ = '-';
+    return writeDigits2(out, date.day);
+}
+
+char* DateTime::formatTimeTo(char* out) const {
+    const auto hms = std::chrono::hh_mm_ss<std::chrono::seconds>(toLocal().second);
+    out = writeDigits2(out, static_cast<uint32_t>(hms.hours().count()));
+    *out++ = ':';
+    out = writeDigits2(out, static_cast<uint32_t>(hms.minutes().count()));
+    *out++ = ':';
+    return writeDigits2(out, static_cast<uint32_t>(hms.seconds().count()));
+}
+
+char* DateTime::formatTo(char* out) const {
+    out = formatDateTo(out);
+    *out++ = ' ';
+    return formatTimeTo(out);
+}
+
+char* DateTime::formatIsoTo(char* out) const {
+    out = formatDateTo(out);
+    *out++ = 'T';
+    return formatTimeTo(out);
+}
+
+bool DateTime::parseTimePoint(std::string_view text, std::chrono::system_clock::time_point& out) noexcept {
+    const char* p = text.data();
+    const size_t n = text.size();
+
+    // "YYYY-MM-DD" and "YYYY-MM-DDTHH:MM" are validated 8 characters at a time
+    if (n == 10) {
+        if (!SOUL_MATCHES8(p, "dddd-dd-") || !isDigit(p[8]) || !isDigit(p[9]))
+            return false;
+    } else if (n >= 16) {
+        if (!SOUL_MATCHES8(p, "dddd-dd-") || !SOUL_MATCHES8(p + 8, "dd?dd:dd"))
+            return false;
+        if (p[10] != 'T' && p[10] != ' ')
+            return false;
+    } else {
+        return false;
+    }
+
+    const int32_t year = static_cast<int32_t>(digits2(p) * 100 + digits2(p + 2));
+    const uint32_t month = digits2(p + 5);
+    const uint32_t day = digits2(p + 8);
+    if (!calendar::isValid(year, month, day))
+        return false;
+
+    const int32_t days = calendar::daysFromCivil(year, month, day);
+    if (n == 10) {
+        out = fromLocal(days, std::chrono::seconds(0));
+        return true;
+    }
+
+    const uint32_t hour = digits2(p + 11);
+    const uint32_t minute = digits2(p + 14);
+    uint32_t second = 0;
+    int64_t nanoseconds = 0;
+    size_t i = 16;
+
+    if (i < n && p[i] == ':') {
+        if (i + 3 > n || !isDigit(p[i + 1]) || !isDigit(p[i + 2]))
+            return false;
+        second = digits2(p + i + 1);
+        i += 3;
+
+        // Fraction of second, digits beyond the nanoseconds are ignored
+        if (i < n && (p[i] == '.' || p[i] == ',')) {
+            const size_t start = ++i;
+            while (i < n && isDigit(p[i])) {
+                if (i - start < 9)
+                    nanoseconds = nanoseconds * 10 + (p[i] - '0');
+                ++i;
+            }
+            if (i == start)
+                return false;
+            for (size_t count = i - start; count < 9; ++count)
+                nanoseconds *= 10;
+        }
+    }
+
+    if (hour > 23 || minute > 59 || second > 59)
+        return false;
+
+    const std::chrono::seconds time = std::chrono::hours(hour) + std::chrono::minutes(minute) + std::chrono::seconds(second);
+    const auto fraction = std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(nanoseconds));
+
+    // No offset: local time
+    if (i == n) {
+        out = fromLocal(days, time) + fraction;
+        return true;
+    }
+
+    std::chrono::seconds offset(0);
+    if (p[i] == 'Z') {
+        if (i + 1 != n)
+            return false;
+    } else if (p[i] == '+' || p[i] == '-') {
+        const bool negative = p[i] == '-';
+        const size_t rest = n - i - 1;
+        const char* q = p + i + 1;
+        uint32_t offsetMinutes = 0;
+
+        if (rest < 2 || !isDigit(q[0]) || !isDigit(q[1]))
+            return false;
+        if (rest == 4 && isDigit(q[2]) && isDigit(q[3])) {
+            offsetMinutes = digits2(q + 2);
+        } else if (rest == 5 && q[2] == ':' && isDigit(q[3]) && isDigit(q[4])) {
+            offsetMinutes = digits2(q + 3);
+        } else if (rest != 2) {
+            return false;
         }
+
+        const uint32_t offsetHours = digits2(q);
+        if (offsetHours > 23 || offsetMinutes > 59)
+            return false;
+
+        offset = std::chrono::hours(offsetHours) + std::chrono::minutes(offsetMinutes);
+        if (negative)
+            offset = -offset;
+    } else {
+        return false;
     }
+
+    out = calendar::toSysDays(days) + time - offset + fraction;
+    return true;
 }
 
-bool DateTime::isBusinessDay() const {
-    std::tm tm = toTm();
-    return tm.tm_wday != 0 && tm.tm_wday != 6; // 0 = Sunday, 6 = Saturday
-}
\ No newline at end of file
+#undef SOUL_MATCHES8
+
+std::optional<DateTime> DateTime::tryParse(std::string_view text) noexcept {
+    std::chrono::system_clock::time_point timePoint;
+    if (!parseTimePoint(text, timePoint))
+        return std::nullopt;
+    return DateTime(timePoint);
+}
+
+DateTime DateTime::parse(std::string_view text) {
+    std::chrono::system_clock::time_point timePoint;
+    if (!parseTimePoint(text, timePoint)) {
+        throw std::invalid_argument(std::format("Invalid ISO-8601 date: {}", text));
+    }
+    return DateTime(timePoint);
+}
+
+size_t DateTime::parseBatch(std::span<const std::string_view> texts, std::span<DateTime> results, std::span<bool> valid) {
+    if (results.size() < texts.size() || valid.size() < texts.size()) {
+        throw std::invalid_argument("Output spans smaller than the texts to parse");
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < texts.size(); ++i) {
+        valid[i] = parseTimePoint(texts[i], results[i].time_point_);
+        count += valid[i];
+    }
+    return count;
+}
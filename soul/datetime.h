@@ -7,13 +7,16 @@ it provides a robust and flexible way to handle date and time.
 #include <chrono>
 #include <iostream>
 #include <format>  // for C++20
+#include <stdexcept>
+
+#include "calendar.h"
+#include "holidaycalendar.h"
 
 #include<ctime>
-#include<regex>
-#include<array>
+#include<optional>
+#include<span>
+#include<string_view>
 #include<utility>
-#include<cstdlib>
-#include <iomanip>
 
 using namespace std::literals; // enables literal suffixes, e.g. 24h, 1ms, 1s.
 
@@ -24,19 +27,12 @@ public:
     // Default constructor that initializes to the current time
     DateTime() : time_point_(std::chrono::system_clock::now()) {}
 
-    // Constructor accepting year, month, and day
+    // Constructor accepting year, month, and day, at midnight local time
     DateTime(int year, int month, int day) {
-        std::tm tm = {};
-        tm.tm_year = year - 1900;  // std::tm uses years since 1900
-        tm.tm_mon = month - 1;     // std::tm months are 0-11
-        tm.tm_mday = day;
-        
-        // Convert std::tm to time_t, then to std::chrono::system_clock::time_point
-        std::time_t time = std::mktime(&tm);
-        if (time == -1) {
+        if (month < 1 || month > 12 || day < 1 || !calendar::isValid(year, month, day)) {
             throw std::invalid_argument("Invalid date");
         }
-        time_point_ = std::chrono::system_clock::from_time_t(time);
+        time_point_ = fromLocal(calendar::daysFromCivil(year, month, day), std::chrono::seconds(0));
     }
 
     // Copy constructor
@@ -74,76 +70,84 @@ public:
         return (time_point_ == dt.time_point_);
     }
 
-    std::string toString() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-
-        // seems not working - C++20 not setup coorectly?
-        // return std::format("{:%Y-%m-%d %H:%M:%S}", *std::localtime(&in_time_t));
-
-        // Version for C++17
-        std::tm tm = *std::localtime(&in_time_t);
+    // Size of a buffer large enough for any of the formatTo writers
+    static constexpr size_t MAX_FORMAT_SIZE = 40;
 
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d %H:%M:%S");
-        return oss.str();
+    std::string toString() const {
+        char buffer[MAX_FORMAT_SIZE];
+        return std::string(buffer, formatTo(buffer));
     }
 
-     std::string timeToString() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-
-        // seems not working - C++20 not setup coorectly?
-        // return std::format("{:%Y-%m-%d %H:%M:%S}", *std::localtime(&in_time_t));
-        std::tm tm = *std::localtime(&in_time_t);
-
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%H:%M:%S");
-        return oss.str();
+    std::string timeToString() const {
+        char buffer[MAX_FORMAT_SIZE];
+        return std::string(buffer, formatTimeTo(buffer));
     }
 
     std::string year_month_day_h() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-
-        // this does not seem to return the correct date
-        // const std::chrono::year_month_day ymd{std::chrono::floor<std::chrono::days>(time_point_)};
-
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d");
-        return oss.str();
+        char buffer[MAX_FORMAT_SIZE];
+        return std::string(buffer, formatDateTo(buffer));
     }
 
     std::string year_month_day() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y%m%d");
-        return oss.str();
+        const auto date = civilDate();
+        return std::format("{:04}{:02}{:02}", date.year, date.month, date.day);
     }
 
     std::string year_month_h() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m");
-        return oss.str();
+        const auto date = civilDate();
+        return std::format("{:04}-{:02}", date.year, date.month);
     }
 
     std::string year_month() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y%m");
-        return oss.str();
+        const auto date = civilDate();
+        return std::format("{:04}{:02}", date.year, date.month);
     }
 
     std::string year() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y");
-        return oss.str();
+        return std::format("{:04}", civilDate().year);
+    }
+
+    // Local calendar date
+    calendar::CivilDate civilDate() const {
+        return calendar::civilFromDays(toLocal().first);
+    }
+
+    // Local serial day number (days since 1970-01-01), see soul::Date
+    int32_t localDays() const {
+        return toLocal().first;
+    }
+
+    // Midnight local time of a serial day number
+    static DateTime fromLocalDays(int32_t days) {
+        return DateTime(fromLocal(days, std::chrono::seconds(0)));
     }
 
+    /**
+     * @brief Allocation-free writers, return the end of the written characters (not null terminated).
+     * formatTo writes "YYYY-MM-DD HH:MM:SS", formatIsoTo "YYYY-MM-DDTHH:MM:SS" in local time,
+     * formatDateTo "YYYY-MM-DD" and formatTimeTo "HH:MM:SS".
+     */
+    char* formatTo(char* out) const;
+    char* formatIsoTo(char* out) const;
+    char* formatDateTo(char* out) const;
+    char* formatTimeTo(char* out) const;
+
+    /**
+     * @brief Parse an ISO-8601 date or timestamp without allocating:
+     * "YYYY-MM-DD", "YYYY-MM-DDTHH:MM[:SS[.fraction]]" with 'T' or ' ' as separator,
+     * followed by an optional "Z", "+HH:MM", "+HHMM" or "+HH" offset.
+     * Without an offset the timestamp is in local time.
+     * tryParse returns std::nullopt on error, parse throws std::invalid_argument.
+     */
+    static std::optional<DateTime> tryParse(std::string_view text) noexcept;
+    static DateTime parse(std::string_view text);
+
+    /**
+     * @brief Parse many timestamps, valid[i] tells whether texts[i] was parsed into results[i].
+     * Fixed-width fields are validated 8 characters at a time. Returns the number of valid texts.
+     */
+    static size_t parseBatch(std::span<const std::string_view> texts, std::span<DateTime> results, std::span<bool> valid);
+
     void currentTime() const {
         auto now = std::chrono::system_clock::now();
         std::time_t now_time = std::chrono::system_clock::to_time_t(now);
@@ -173,29 +177,37 @@ public:
 
     bool isBusinessDay() const;
 
+    // Business days skipping the holidays of the calendar as well as weekends
+    void addBusinessDays(int days, const HolidayCalendar& holidays);
+
+    void subtractBusinessDays(int days, const HolidayCalendar& holidays);
+
+    bool isBusinessDay(const HolidayCalendar& holidays) const;
+
+    // Move to a business day according to the roll convention, keeping the time of the day
+    void roll(RollConvention convention, const HolidayCalendar& holidays);
+
+    // Number of business days from this date (included) to the other date (excluded)
+    int businessDaysUntil(const DateTime& other, const HolidayCalendar& holidays) const;
+
 private:
-    // toTm Method: Converts the time_point_ to a std::tm structure.
-    std::tm toTm() const {
-        auto in_time_t = std::chrono::system_clock::to_time_t(time_point_);
-        std::tm tm = *std::localtime(&in_time_t);
-        return tm;
-    }
-
-    // normalizeTm Method: Uses std::mktime to normalize the std::tm structure, 
-    // which handles overflow and underflow of months and years.
-    void normalizeTm(std::tm& tm) const {
-        // Normalize the time structure (e.g., handle overflow of months into years)
-        std::mktime(&tm);
-    }
-
-    // updateFromTm Method: Converts a normalized std::tm structure back to time_point_.
-    void updateFromTm(const std::tm& tm) {
-        // Convert the normalized tm back to time_point_
-        std::time_t time = std::mktime(const_cast<std::tm*>(&tm));
-        if (time == -1) {
-            throw std::invalid_argument("Invalid date after normalization");
-        }
-        time_point_ = std::chrono::system_clock::from_time_t(time);
+    explicit DateTime(std::chrono::system_clock::time_point time_point) : time_point_(time_point) {}
+
+    // parseTimePoint Method: Shared by parse, tryParse and parseBatch, false on invalid input.
+    static bool parseTimePoint(std::string_view text, std::chrono::system_clock::time_point& out) noexcept;
+
+    // toLocal Method: Splits the time point into the local serial day number and the time of the day.
+    std::pair<int32_t, std::chrono::seconds> toLocal() const {
+        const auto instant = std::chrono::floor<std::chrono::seconds>(time_point_);
+        const auto local = instant + calendar::localUtcOffset(instant);
+        const auto days = std::chrono::floor<std::chrono::days>(local);
+        return {static_cast<int32_t>(days.time_since_epoch().count()), local - days};
+    }
+
+    // fromLocal Method: Time point of a local serial day number and time of the day.
+    static std::chrono::system_clock::time_point fromLocal(int32_t days, std::chrono::seconds time) {
+        const std::chrono::local_seconds local {std::chrono::days(days) + time};
+        return calendar::toSysDays(days) + time - calendar::localUtcOffset(local);
     }
 
 private:
@@ -2,12 +2,17 @@
 #include "entity.h"
 // #include "scene.h"
 
-// Generate a random number generator for entity IDs
-soul::RandomNumberGenerator soul::Entity::_gen;
+// Sequence of the entity IDs, 0 is never given
+std::atomic<uint32_t> soul::Entity::_nextId {1};
 
 // Constructor: Initialize the entity with a unique ID, tag, and active state
 soul::Entity::Entity(const std::string& tag)
-    : _tag(tag), _id(_gen.getID()), _active(true) {}
+    : Entity(TagInterner::getInstance().intern(tag)) {}
+
+// Constructor: Without string work, for spawners caching their TagId
+soul::Entity::Entity(TagId tagId)
+    : _tagId(tagId), _tag(&TagInterner::getInstance().name(tagId)),
+      _id(_nextId.fetch_add(1, std::memory_order_relaxed)), _active(true) {}
 
 // Get the unique ID of the entity
 const uint32_t& soul::Entity::ID() const {
@@ -16,10 +21,13 @@ const uint32_t& soul::Entity::ID() const {
 
 // Get the tag of the entity
 const std::string& soul::Entity::tag() const {
-    return _tag;
+    return *_tag;
 }
 
 // Set the active state of the entity
 void soul::Entity::setActive(bool active) {
+    const bool deactivated = _active && !active;
     _active = active;
+    if (deactivated && _observer)
+        _observer->onDeactivated(*this);
 }
\ No newline at end of file
@@ -2,10 +2,10 @@
 
 #include "core.h"
 #include "logger.h"
+#include "taginterner.h"
 
+#include <atomic>
 #include <iostream>
-#include <random>
-#include <ctime>
 #include <memory>
 #include <string>
 #include <cstdint>
@@ -13,33 +13,37 @@
 
 namespace soul {
 
-// Random number generator class
-class RandomNumberGenerator {
-    uint32_t _min = 1;
-    uint32_t _max = 1000000;
-public:
-    // Constructor: Seed the random number generator with the current time by default
-    RandomNumberGenerator()
-        : generator(static_cast<unsigned>(std::time(nullptr))),
-          distribution(_min, _max) {}
-
-    // Constructor: Allow custom seeding
-    RandomNumberGenerator(unsigned seed) : generator(seed), distribution(_min, _max) {}
+/**
+ * @brief Handle of an entity in the EntityManager: index of its slot and generation of the slot.
+ * The generation changes when the entity dies, so a handle kept after that is detected
+ * as stale instead of reaching the entity reusing the slot.
+ */
+struct EntityHandle {
+    static constexpr uint32_t INVALID = ~0u;
 
-    // Generate a random integer in the range [min, max]
-    uint32_t getID() {
-        return distribution(generator);
-    }
+    uint32_t index {INVALID};
+    uint32_t generation {0};
 
-private:
-    // Mersenne Twister 19937 generator and uniform distribution
-    std::mt19937 generator; // Mersenne Twister 19937 generator
-    std::uniform_int_distribution<uint32_t> distribution; // Distribution defined as a member variable
+    bool isValid() const { return index != INVALID; }
+    bool operator==(const EntityHandle&) const = default;
 };
 
+// Properties of an entity, bit per property, matched by the views of the EntityManager
+using EntityFlags = uint32_t;
+
+inline constexpr EntityFlags ENTITY_RENDERABLE = 1u << 0;
+inline constexpr EntityFlags ENTITY_COLLIDER = 1u << 1;
+
 // Forward declaration of AScene
 // class AScene;
 class Entity;
+class EntityManager;
+
+// Told when an entity it watches is deactivated, the EntityManager keeps its kill list with it
+struct IEntityObserver {
+    virtual ~IEntityObserver() = default;
+    virtual void onDeactivated(Entity& e) = 0;
+};
 
 struct IRenderable {
     // Render the entity with specialized logic
@@ -58,8 +62,9 @@ struct IUpdatable {
  * An entity can be a player, an enemy, a projectile, or any other object in the game world.
  * 
  * Each entity has a unique ID, a tag, and an active state.
- * The unique ID is used to identify the entity.
- * The tag is a string that describes the entity.
+ * The unique ID is used to identify the entity, it comes from a process-wide sequence.
+ * The handle is given by the EntityManager once the entity is added to it.
+ * The tag is a string that describes the entity, interned once as a TagId.
  * The active state determines if the entity is active in the game world.
  * 
  * The entity class is abstract and serves as the base class for all entities in the game world.
@@ -68,11 +73,24 @@ struct IUpdatable {
  */
 class Entity : public IRenderable, IUpdatable {
 private:
-    static RandomNumberGenerator _gen;
-    // Tag of the entity
-    std::string _tag;
+    friend class EntityManager;
+
+    // Next unique ID, shared by all the threads creating entities
+    static std::atomic<uint32_t> _nextId;
+    // Interned tag of the entity, and its name owned by the TagInterner
+    TagId _tagId {0};
+    const std::string* _tag {nullptr};
     // Unique ID of the entity
     uint32_t _id {0};
+    // Slot in the EntityManager, invalid until the entity is added to it
+    EntityHandle _handle;
+    // Positions in the EntityManager lists, for removal by swap and pop
+    uint32_t _denseIndex {0};
+    uint32_t _tagIndex {0};
+    // Notified when the entity is deactivated
+    IEntityObserver* _observer {nullptr};
+    // Properties matched by the views
+    EntityFlags _flags {0};
     // Active state of the entity
     bool _active {true};
     // Renderable is necessarily defined in a Scene
@@ -81,14 +99,24 @@ private:
 protected:
     LoggerManager& logManager = LoggerManager::getInstance();
 
+    // Before the entity is added to the EntityManager, EntityManager::setFlags() after
+    _ALWAYS_INLINE_ void setFlags(EntityFlags flags) { _flags = flags; }
+
 public:
     Entity() = delete;
     explicit Entity(const std::string& tag);
+    explicit Entity(TagId tagId);
     virtual ~Entity() = default;
 
     const std::string& tag() const;
+    _ALWAYS_INLINE_ TagId tagId() const { return _tagId; }
     const uint32_t& ID() const;
 
+    _ALWAYS_INLINE_ EntityHandle handle() const { return _handle; }
+
+    _ALWAYS_INLINE_ EntityFlags flags() const { return _flags; }
+    _ALWAYS_INLINE_ bool hasFlags(EntityFlags flags) const { return (_flags & flags) == flags; }
+
     // Check if the entity is active
     _ALWAYS_INLINE_ bool isActive() const { return _active; }
 
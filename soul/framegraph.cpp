@@ -0,0 +1,201 @@
+#include "framegraph.h"
+#include "profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+
+using namespace soul;
+
+namespace {
+
+struct ResourceRegistry {
+    std::mutex mutex;
+    std::vector<std::string> names;
+};
+
+ResourceRegistry& registry() {
+    static ResourceRegistry instance;
+    return instance;
+}
+
+double toMilliseconds(std::chrono::nanoseconds duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+std::string joinResources(ResourceMask mask) {
+    std::string names;
+    for (uint32_t id = 0; id < FrameGraph::MAX_RESOURCES; ++id) {
+        if (!(mask & (ResourceMask(1) << id)))
+            continue;
+        if (!names.empty())
+            names += ", ";
+        names += FrameGraph::resourceName(id);
+    }
+    return names.empty() ? "-" : names;
+}
+
+} // namespace
+
+uint32_t FrameGraph::registerResource(std::string_view typeName) {
+    // GCC appends the aliases of the signature after the type
+    typeName = typeName.substr(0, typeName.find(';'));
+
+    ResourceRegistry& resources = registry();
+    std::lock_guard<std::mutex> lock(resources.mutex);
+    if (resources.names.size() >= MAX_RESOURCES)
+        throw std::length_error(std::format("FrameGraph: more than {} resources", MAX_RESOURCES));
+    resources.names.emplace_back(typeName);
+    return static_cast<uint32_t>(resources.names.size() - 1);
+}
+
+std::string FrameGraph::resourceName(uint32_t id) {
+    ResourceRegistry& resources = registry();
+    std::lock_guard<std::mutex> lock(resources.mutex);
+    if (id >= resources.names.size())
+        throw std::out_of_range(std::format("FrameGraph: unknown resource {}", id));
+    return resources.names[id];
+}
+
+FrameGraph::NodeId FrameGraph::addSystem(std::string name, ResourceMask reads, ResourceMask writes, System system) {
+    Node& node = _nodes.emplace_back();
+    node.name = std::move(name);
+    node.reads = reads | writes;
+    node.writes = writes;
+    node.system = std::move(system);
+    _compiled = false;
+    return static_cast<NodeId>(_nodes.size() - 1);
+}
+
+void FrameGraph::compile() {
+    const size_t count = _nodes.size();
+    const size_t words = (count + 63) / 64;
+    // Bit j of ancestors[i] is set when node j runs before node i
+    std::vector<std::vector<uint64_t>> ancestors(count, std::vector<uint64_t>(words, 0));
+
+    for (auto& node : _nodes) {
+        node.dependencies.clear();
+        node.dependents.clear();
+    }
+
+    for (NodeId i = 0; i < count; ++i) {
+        Node& node = _nodes[i];
+        // Latest first: an earlier conflicting node already ordered through a later one needs no edge
+        for (NodeId j = i; j-- > 0;) {
+            const Node& before = _nodes[j];
+            const bool conflict = (before.writes & node.reads) || (before.reads & node.writes);
+            if (!conflict || (ancestors[i][j / 64] & (uint64_t(1) << (j % 64))))
+                continue;
+
+            node.dependencies.push_back(j);
+            _nodes[j].dependents.push_back(i);
+            for (size_t w = 0; w < words; ++w)
+                ancestors[i][w] |= ancestors[j][w];
+            ancestors[i][j / 64] |= uint64_t(1) << (j % 64);
+        }
+        std::sort(node.dependencies.begin(), node.dependencies.end());
+    }
+
+    _pending.reset(new std::atomic<uint32_t>[count]);
+    _compiled = true;
+}
+
+void FrameGraph::run(JobSystem& jobs, float dt) {
+    if (!_compiled)
+        compile();
+
+    _frameStart = TscClock::now();
+
+    JobCounter counter;
+    for (NodeId id = 0; id < _nodes.size(); ++id)
+        _pending[id].store(static_cast<uint32_t>(_nodes[id].dependencies.size()), std::memory_order_relaxed);
+
+    for (NodeId id = 0; id < _nodes.size(); ++id) {
+        if (_nodes[id].dependencies.empty())
+            jobs.submit([this, id, &jobs, &counter, dt]() { execute(id, jobs, counter, dt); }, counter);
+    }
+    jobs.wait(counter);
+
+    _frameTime = TscClock::now() - _frameStart;
+}
+
+void FrameGraph::execute(NodeId id, JobSystem& jobs, JobCounter& counter, float dt) {
+    Node& node = _nodes[id];
+    const TscClock::time_point begin = TscClock::now();
+    {
+        SOUL_PROFILE_SCOPE(node.name.c_str());
+        node.system(dt);
+    }
+    node.start = begin - _frameStart;
+    node.duration = TscClock::now() - begin;
+    node.worker = jobs.currentWorker();
+
+    // A throwing system never gets here, its dependents are skipped and wait() rethrows
+    for (const NodeId dependent : node.dependents) {
+        if (_pending[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            jobs.submit([this, dependent, &jobs, &counter, dt]() { execute(dependent, jobs, counter, dt); }, counter);
+    }
+}
+
+void FrameGraph::runSerial(float dt) {
+    if (!_compiled)
+        compile();
+
+    _frameStart = TscClock::now();
+    for (Node& node : _nodes) {
+        const TscClock::time_point begin = TscClock::now();
+        {
+            SOUL_PROFILE_SCOPE(node.name.c_str());
+            node.system(dt);
+        }
+        node.start = begin - _frameStart;
+        node.duration = TscClock::now() - begin;
+        node.worker = JobSystem::NO_WORKER;
+    }
+    _frameTime = TscClock::now() - _frameStart;
+}
+
+std::chrono::nanoseconds FrameGraph::getCriticalPath() const {
+    // Dependencies come first in declaration order
+    std::vector<std::chrono::nanoseconds> finish(_nodes.size());
+    std::chrono::nanoseconds longest {0};
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        std::chrono::nanoseconds ready {0};
+        for (const NodeId dependency : _nodes[i].dependencies)
+            ready = std::max(ready, finish[dependency]);
+        finish[i] = ready + _nodes[i].duration;
+        longest = std::max(longest, finish[i]);
+    }
+    return longest;
+}
+
+void FrameGraph::writeDot(std::ostream& out) const {
+    out << "digraph FrameGraph {\n";
+    out << "    rankdir=LR;\n";
+    out << "    node [shape=box, fontname=\"monospace\"];\n";
+    out << std::format("    label=\"frame {:.3f} ms, critical path {:.3f} ms\";\n",
+        toMilliseconds(_frameTime), toMilliseconds(getCriticalPath()));
+
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        const Node& node = _nodes[i];
+        const std::string worker = node.worker == JobSystem::NO_WORKER ? "caller" : std::format("worker {}", node.worker);
+        out << std::format("    n{} [label=\"{}\\nreads: {}\\nwrites: {}\\n{:.3f} ms at +{:.3f} ms, {}\"];\n",
+            i, node.name, joinResources(node.reads & ~node.writes), joinResources(node.writes),
+            toMilliseconds(node.duration), toMilliseconds(node.start), worker);
+    }
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        for (const NodeId dependent : _nodes[i].dependents)
+            out << std::format("    n{} -> n{};\n", i, dependent);
+    }
+    out << "}\n";
+}
+
+void FrameGraph::writeDot(const std::string& fileName) const {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Error: Cannot write the frame graph file {}.", fileName));
+    }
+    writeDot(file);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "core.h"
+#include "jobsystem.h"
+#include "time_elapsed.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace soul {
+
+// Bit per resource id
+using ResourceMask = uint64_t;
+
+/**
+ * @brief Systems of a frame and the resources they use.
+ * A resource is any type whose state a system touches: an ECS component, the Player, the EntityManager...
+ * Each system declares the resources it reads and writes, a system writing a resource runs after
+ * the systems declared before it that use it, and a system reading it after those that write it.
+ * The systems are the nodes of a DAG in declaration order: the declaration order is a valid serial order,
+ * and run() executes the independent systems in parallel on a JobSystem.
+ * Per-node timings of the last run are kept, writeDot() dumps the graph with them.
+ */
+class FrameGraph {
+public:
+    using NodeId = uint32_t;
+    using System = std::function<void(float dt)>;
+
+    static constexpr size_t MAX_RESOURCES = 64;
+
+    struct Node {
+        std::string name;
+        ResourceMask reads {0};
+        ResourceMask writes {0};
+        System system;
+
+        // Direct dependencies and dependents, without the edges implied by others
+        std::vector<NodeId> dependencies;
+        std::vector<NodeId> dependents;
+
+        // Last run, start relative to the start of the frame
+        std::chrono::nanoseconds start {0};
+        std::chrono::nanoseconds duration {0};
+        size_t worker {JobSystem::NO_WORKER};
+    };
+
+    // Id of the resource of type T, assigned on first use
+    template<typename T>
+    static uint32_t resourceId() {
+        static const uint32_t id = registerResource(get_type_name<T>());
+        return id;
+    }
+
+    template<typename... Ts>
+    static ResourceMask resources() {
+        return ((ResourceMask(1) << resourceId<Ts>()) | ... | ResourceMask(0));
+    }
+
+    static std::string resourceName(uint32_t id);
+
+    /**
+     * @brief Adds a system after the ones already declared.
+     * A resource written is also read, it does not need to be in reads.
+     */
+    NodeId addSystem(std::string name, ResourceMask reads, ResourceMask writes, System system);
+
+    // Builds the edges, done by run() when systems were added
+    void compile();
+
+    // Runs every system once, the independent ones in parallel, then rethrows the first error
+    void run(JobSystem& jobs, float dt);
+
+    // Runs every system on the calling thread in declaration order
+    void runSerial(float dt);
+
+    size_t size() const { return _nodes.size(); }
+    const Node& node(NodeId id) const { return _nodes[id]; }
+
+    // Wall time of the last run
+    std::chrono::nanoseconds getLastFrameTime() const { return _frameTime; }
+
+    // Longest chain of the last run: the frame time with unlimited workers
+    std::chrono::nanoseconds getCriticalPath() const;
+
+    // Graphviz dump, nodes labelled with their resources and last timings
+    void writeDot(std::ostream& out) const;
+    void writeDot(const std::string& fileName) const;
+
+private:
+    static uint32_t registerResource(std::string_view typeName);
+
+    // Runs the node and submits the dependents it was the last dependency of
+    void execute(NodeId id, JobSystem& jobs, JobCounter& counter, float dt);
+
+private:
+    // Stable addresses, the profiler keeps the names
+    std::deque<Node> _nodes;
+    bool _compiled {true};
+
+    // Dependencies left in the current run
+    std::unique_ptr<std::atomic<uint32_t>[]> _pending;
+    TscClock::time_point _frameStart;
+    std::chrono::nanoseconds _frameTime {0};
+};
+
+} // namespace soul
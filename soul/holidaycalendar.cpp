@@ -0,0 +1,121 @@
+#include "holidaycalendar.h"
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+
+using namespace soul;
+
+HolidayCalendar::HolidayCalendar(int32_t firstYear, int32_t lastYear) {
+    if (lastYear < firstYear) {
+        throw std::invalid_argument("Invalid holiday calendar year range");
+    }
+    _first = calendar::daysFromCivil(firstYear, 1, 1);
+    _last = calendar::daysFromCivil(lastYear + 1, 1, 1);
+
+    const size_t words = (static_cast<size_t>(_last - _first) + 63) / 64;
+    _words.assign(words, 0);
+    _rank.assign(words + 1, 0);
+}
+
+void HolidayCalendar::addHoliday(int32_t days) {
+    if (days < _first || days >= _last) {
+        throw std::out_of_range("Holiday outside of the calendar year range");
+    }
+    if (isHoliday(days))
+        return;
+
+    const uint32_t offset = static_cast<uint32_t>(days - _first);
+    _words[offset >> 6] |= uint64_t(1) << (offset & 63);
+    ++_count;
+
+    // Holidays on weekends do not change the business day counts
+    if (!calendar::isWeekend(days)) {
+        for (size_t i = (offset >> 6) + 1; i < _rank.size(); ++i)
+            ++_rank[i];
+    }
+}
+
+void HolidayCalendar::removeHoliday(int32_t days) {
+    if (!isHoliday(days))
+        return;
+
+    const uint32_t offset = static_cast<uint32_t>(days - _first);
+    _words[offset >> 6] &= ~(uint64_t(1) << (offset & 63));
+    --_count;
+
+    if (!calendar::isWeekend(days)) {
+        for (size_t i = (offset >> 6) + 1; i < _rank.size(); ++i)
+            --_rank[i];
+    }
+}
+
+int32_t HolidayCalendar::holidaysBefore(int32_t days) const {
+    if (days <= _first)
+        return 0;
+    if (days >= _last)
+        return _rank.back();
+
+    const uint32_t offset = static_cast<uint32_t>(days - _first);
+    const uint32_t word = offset >> 6;
+    const uint64_t below = (uint64_t(1) << (offset & 63)) - 1;
+    const int32_t start = _first + static_cast<int32_t>(word) * 64;
+    return _rank[word] + std::popcount(_words[word] & below & weekdayMask(start));
+}
+
+uint64_t HolidayCalendar::weekdayMask(int32_t days) {
+    // One mask per weekday of the first day of the word
+    static constexpr std::array<uint64_t, 7> masks = []() {
+        std::array<uint64_t, 7> result {};
+        for (uint32_t first = 0; first < 7; ++first) {
+            for (uint32_t bit = 0; bit < 64; ++bit) {
+                const uint32_t weekday = (first + bit) % 7;
+                if (weekday != 0 && weekday != 6)
+                    result[first] |= uint64_t(1) << bit;
+            }
+        }
+        return result;
+    }();
+    return masks[calendar::weekdayFromDays(days)];
+}
+
+int32_t HolidayCalendar::nthBusinessDay(int32_t n) const {
+    // The business day d verifies weekdaysBefore(d) = n + holidaysBefore(d + 1).
+    // Starting from the weekday with count n, every step skips the holidays met so far:
+    // the sequence only grows and stops on d after a step per cluster of holidays.
+    int32_t days = calendar::nthWeekday(n);
+    for (;;) {
+        const int32_t next = calendar::nthWeekday(n + holidaysBefore(days + 1));
+        if (next == days)
+            return days;
+        days = next;
+    }
+}
+
+int32_t HolidayCalendar::addBusinessDays(int32_t days, int32_t n) const {
+    if (n > 0)
+        return nthBusinessDay(businessDaysBefore(days + 1) + n - 1);
+    if (n < 0)
+        return nthBusinessDay(businessDaysBefore(days) + n);
+    return days;
+}
+
+int32_t HolidayCalendar::adjust(int32_t days, RollConvention convention) const {
+    if (convention == RollConvention::Unadjusted || isBusinessDay(days))
+        return days;
+
+    switch (convention) {
+    case RollConvention::Following:
+        return addBusinessDays(days, 1);
+    case RollConvention::ModifiedFollowing: {
+        const int32_t following = addBusinessDays(days, 1);
+        if (calendar::civilFromDays(following).month == calendar::civilFromDays(days).month)
+            return following;
+        return addBusinessDays(days, -1);
+    }
+    case RollConvention::Preceding:
+        return addBusinessDays(days, -1);
+    default:
+        return days;
+    }
+}
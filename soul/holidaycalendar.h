@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "calendar.h"
+
+namespace soul {
+
+/**
+ * @brief How a date falling on a non business day is moved to a business day.
+ */
+enum class RollConvention : uint8_t {
+    Unadjusted,         // Keep the date
+    Following,          // Next business day
+    ModifiedFollowing,  // Next business day, unless it is in the next month, then the previous one
+    Preceding           // Previous business day
+};
+
+/**
+ * @brief Holidays of a range of years, stored as one bit per day.
+ * Business days are the weekdays that are not holidays. Counting uses a rank
+ * table (holidays before each 64-day word), so businessDaysBetween and
+ * addBusinessDays cost a few popcounts whatever the distance.
+ * Outside the year range only weekends are non business days.
+ * Calendars are built once and then queried: adding a holiday is O(words).
+ * Dates are serial day numbers (days since 1970-01-01, see calendar.h).
+ */
+class HolidayCalendar {
+public:
+    // Weekends only
+    HolidayCalendar() = default;
+
+    // Holidays can be set from January 1st of firstYear to December 31st of lastYear
+    HolidayCalendar(int32_t firstYear, int32_t lastYear);
+
+    // Throws std::out_of_range outside the year range
+    void addHoliday(int32_t days);
+
+    void addHoliday(int32_t year, uint32_t month, uint32_t day) {
+        addHoliday(calendar::daysFromCivil(year, month, day));
+    }
+
+    void removeHoliday(int32_t days);
+
+    bool isHoliday(int32_t days) const {
+        if (days < _first || days >= _last)
+            return false;
+        const uint32_t offset = static_cast<uint32_t>(days - _first);
+        return (_words[offset >> 6] >> (offset & 63)) & 1;
+    }
+
+    bool isBusinessDay(int32_t days) const {
+        return !calendar::isWeekend(days) && !isHoliday(days);
+    }
+
+    // Number of business days in [from, to), negative when to < from
+    int32_t businessDaysBetween(int32_t from, int32_t to) const {
+        return businessDaysBefore(to) - businessDaysBefore(from);
+    }
+
+    // Move n business days forward (or backward when negative), 0 leaves the date unchanged
+    int32_t addBusinessDays(int32_t days, int32_t n) const;
+
+    // Move a non business day to a business day according to the convention
+    int32_t adjust(int32_t days, RollConvention convention) const;
+
+    int32_t firstDay() const { return _first; }
+    int32_t lastDay() const { return _last - 1; }
+    int32_t getCountHolidays() const { return _count; }
+
+private:
+    // Business days in [FIRST_MONDAY, z)
+    int32_t businessDaysBefore(int32_t days) const {
+        return calendar::weekdaysBefore(days) - holidaysBefore(days);
+    }
+
+    // Holidays falling on weekdays in [_first, days)
+    int32_t holidaysBefore(int32_t days) const;
+
+    // Business day with the given count, inverse of businessDaysBefore
+    int32_t nthBusinessDay(int32_t n) const;
+
+    // Weekday bits of the word starting on the given day
+    static uint64_t weekdayMask(int32_t days);
+
+private:
+    int32_t _first {0};
+    int32_t _last {0};
+    int32_t _count {0};
+    std::vector<uint64_t> _words;
+    std::vector<int32_t> _rank {0};  // Holidays on weekdays before each word, one extra entry for the total
+};
+
+} // namespace soul
@@ -0,0 +1,183 @@
+#include "jobsystem.h"
+
+using namespace soul;
+
+namespace {
+
+// Pool and index of the calling worker thread
+thread_local const JobSystem* t_pool = nullptr;
+thread_local size_t t_index = JobSystem::NO_WORKER;
+
+// Spins before sleeping, a frame submits its next jobs within microseconds
+constexpr int SPINS_BEFORE_SLEEP = 64;
+
+} // namespace
+
+JobSystem::JobSystem(size_t workers) {
+    _workers.reserve(workers);
+    for (size_t i = 0; i < workers; ++i)
+        _workers.push_back(std::make_unique<Worker>());
+    // Deques first, the workers steal from each other as soon as they start
+    for (size_t i = 0; i < workers; ++i)
+        _workers[i]->thread = std::thread([this, i]() { run(i); });
+}
+
+JobSystem::~JobSystem() {
+    _stop.store(true, std::memory_order_seq_cst);
+    _signal.fetch_add(1, std::memory_order_seq_cst);
+    _signal.notify_all();
+    for (auto& worker : _workers)
+        worker->thread.join();
+
+    // Jobs never run, their counters are gone with their callers
+    for (Job* job : _injection)
+        delete job;
+    for (auto& worker : _workers) {
+        while (Job* job = worker->deque.steal())
+            delete job;
+    }
+}
+
+size_t JobSystem::currentWorker() const {
+    return t_pool == this ? t_index : NO_WORKER;
+}
+
+void JobSystem::submit(std::function<void()> task, JobCounter& counter) {
+    counter.add();
+    Job* job = new Job {std::move(task), &counter};
+
+    const size_t index = currentWorker();
+    if (index != NO_WORKER) {
+        // A full deque runs the job right away, it is never lost
+        if (!_workers[index]->deque.push(job)) {
+            execute(job);
+            return;
+        }
+    } else {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        _injection.push_back(job);
+        _injectionSize.fetch_add(1, std::memory_order_seq_cst);
+    }
+    wake();
+}
+
+void JobSystem::wake() {
+    _signal.fetch_add(1, std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_seq_cst) > 0)
+        _signal.notify_one();
+}
+
+void JobSystem::execute(Job* job) {
+    try {
+        job->task();
+    } catch (...) {
+        job->counter->setError(std::current_exception());
+    }
+    JobCounter* counter = job->counter;
+    delete job;
+    _executed.fetch_add(1, std::memory_order_relaxed);
+    // The waiter may destroy the counter as soon as it is done
+    counter->done();
+
+    // Wake the threads sleeping in wait, they check their counter again
+    _completed.fetch_add(1, std::memory_order_seq_cst);
+    if (_waiting.load(std::memory_order_seq_cst) > 0)
+        _completed.notify_all();
+}
+
+Job* JobSystem::findJob(size_t index) {
+    if (index != NO_WORKER) {
+        if (Job* job = _workers[index]->deque.pop())
+            return job;
+    }
+
+    if (_injectionSize.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(_injectionMutex);
+        if (!_injection.empty()) {
+            Job* job = _injection.front();
+            _injection.pop_front();
+            _injectionSize.fetch_sub(1, std::memory_order_seq_cst);
+            return job;
+        }
+    }
+
+    // Victims in turn, starting after the thief so they are not all robbed by the same order
+    const size_t count = _workers.size();
+    const size_t start = index == NO_WORKER ? 0 : index + 1;
+    for (size_t i = 0; i < count; ++i) {
+        const size_t victim = (start + i) % count;
+        if (victim == index)
+            continue;
+        if (Job* job = _workers[victim]->deque.steal()) {
+            _stolen.fetch_add(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+void JobSystem::run(size_t index) {
+    t_pool = this;
+    t_index = index;
+
+    int spins = 0;
+    while (!_stop.load(std::memory_order_relaxed)) {
+        if (Job* job = findJob(index)) {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Sleep until the next submit, the last look for a job is after the signal is read
+        const uint32_t signal = _signal.load(std::memory_order_seq_cst);
+        _sleeping.fetch_add(1, std::memory_order_seq_cst);
+        if (Job* job = findJob(index)) {
+            _sleeping.fetch_sub(1, std::memory_order_seq_cst);
+            execute(job);
+            spins = 0;
+            continue;
+        }
+        if (!_stop.load(std::memory_order_seq_cst))
+            _signal.wait(signal, std::memory_order_seq_cst);
+        _sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        spins = 0;
+    }
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    const size_t index = currentWorker();
+    int spins = 0;
+    while (!counter.isDone()) {
+        if (Job* job = findJob(index)) {
+            execute(job);
+            spins = 0;
+            continue;
+        }
+
+        if (++spins < SPINS_BEFORE_SLEEP) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Sleep until a job completes, the last checks are after the completion count is read
+        const uint32_t completed = _completed.load(std::memory_order_seq_cst);
+        _waiting.fetch_add(1, std::memory_order_seq_cst);
+        if (!counter.isDone()) {
+            if (Job* job = findJob(index)) {
+                _waiting.fetch_sub(1, std::memory_order_seq_cst);
+                execute(job);
+                spins = 0;
+                continue;
+            }
+            _completed.wait(completed, std::memory_order_seq_cst);
+        }
+        _waiting.fetch_sub(1, std::memory_order_seq_cst);
+        spins = 0;
+    }
+    counter.rethrow();
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace soul {
+
+class JobCounter;
+
+struct Job {
+    std::function<void()> task;
+    JobCounter* counter {nullptr};
+};
+
+/**
+ * @brief Chase-Lev work-stealing deque of a worker (Le, Pop, Cohen, Nardelli 2013).
+ * The owner pushes and pops at the bottom without locks, thieves steal from the top
+ * with a compare and swap, the last item is raced for with the same compare and swap.
+ * The capacity is fixed: push returns false when the deque is full.
+ */
+class WorkStealingDeque {
+public:
+    static constexpr int64_t CAPACITY = 1 << 12;
+
+    // Owner only
+    bool push(Job* job) {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed);
+        const int64_t top = _top.load(std::memory_order_acquire);
+        if (bottom - top >= CAPACITY)
+            return false;
+        _jobs[bottom & (CAPACITY - 1)].store(job, std::memory_order_relaxed);
+        // Publishes the job to the thieves
+        _bottom.store(bottom + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only, newest first
+    Job* pop() {
+        const int64_t bottom = _bottom.load(std::memory_order_relaxed) - 1;
+        // The reservation of the bottom must be seen before the top is read
+        _bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = _top.load(std::memory_order_seq_cst);
+
+        if (top > bottom) {
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        Job* job = _jobs[bottom & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (top == bottom) {
+            // Last job, a thief may be taking it
+            if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                job = nullptr;
+            _bottom.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // Any thread, oldest first
+    Job* steal() {
+        int64_t top = _top.load(std::memory_order_seq_cst);
+        const int64_t bottom = _bottom.load(std::memory_order_seq_cst);
+        if (top >= bottom)
+            return nullptr;
+
+        Job* job = _jobs[top & (CAPACITY - 1)].load(std::memory_order_relaxed);
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return job;
+    }
+
+    bool empty() const {
+        return _bottom.load(std::memory_order_acquire) <= _top.load(std::memory_order_acquire);
+    }
+
+private:
+    alignas(64) std::atomic<int64_t> _top {0};
+    alignas(64) std::atomic<int64_t> _bottom {0};
+    std::unique_ptr<std::atomic<Job*>[]> _jobs {new std::atomic<Job*>[CAPACITY]};
+};
+
+/**
+ * @brief Number of jobs still running, used as a latch: JobSystem::wait(counter)
+ * returns once every job submitted with it is done.
+ * The first exception thrown by one of the jobs is kept and rethrown by wait.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    void add(int64_t count = 1) { _pending.fetch_add(count, std::memory_order_relaxed); }
+    void done() { _pending.fetch_sub(1, std::memory_order_acq_rel); }
+    bool isDone() const { return _pending.load(std::memory_order_acquire) == 0; }
+
+    void setError(std::exception_ptr error) {
+        std::lock_guard<std::mutex> lock(_errorMutex);
+        if (!_error)
+            _error = error;
+    }
+
+    void rethrow() {
+        std::exception_ptr error;
+        {
+            std::lock_guard<std::mutex> lock(_errorMutex);
+            error = std::exchange(_error, nullptr);
+        }
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+private:
+    std::atomic<int64_t> _pending {0};
+    std::mutex _errorMutex;
+    std::exception_ptr _error;
+};
+
+/**
+ * @brief Fixed pool of worker threads with work stealing.
+ * Each worker owns a Chase-Lev deque: the jobs it submits go to its own deque, taken back
+ * newest first (cache warm), while idle workers steal the oldest jobs of the others.
+ * Threads outside the pool submit through a shared injection queue.
+ * Waiting on a counter never blocks a worker: the waiting thread runs pending jobs meanwhile,
+ * so jobs may submit and wait for other jobs (nested parallelFor).
+ * Idle workers sleep on an atomic wait and are woken by the next submit.
+ */
+class JobSystem {
+public:
+    static constexpr size_t NO_WORKER = ~size_t(0);
+
+    // One worker per core but the calling thread by default
+    explicit JobSystem(size_t workers = defaultWorkers());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    size_t getCountWorkers() const { return _workers.size(); }
+
+    static size_t defaultWorkers() {
+        const size_t cores = std::thread::hardware_concurrency();
+        return cores > 1 ? cores - 1 : 1;
+    }
+
+    void submit(std::function<void()> task, JobCounter& counter);
+
+    // Runs pending jobs until the counter is done, sleeping when there are none to run,
+    // then rethrows the first error of its jobs
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief Calls f(begin, end) on sub-ranges of [0, count) of at most grain items, in parallel,
+     * and returns when they are all done. The range is split in halves lazily: the caller
+     * keeps the first half and submits the second, so thieves take the biggest pieces.
+     */
+    template<typename F>
+    void parallelFor(size_t count, size_t grain, F&& f) {
+        if (count == 0)
+            return;
+        JobCounter counter;
+        try {
+            splitRange(0, count, std::max<size_t>(grain, 1), f, counter);
+        } catch (...) {
+            // The submitted halves still use f and the counter
+            counter.setError(std::current_exception());
+        }
+        wait(counter);
+    }
+
+    // Index of the calling worker in this pool, NO_WORKER for other threads
+    size_t currentWorker() const;
+
+    uint64_t getExecutedJobs() const { return _executed.load(std::memory_order_relaxed); }
+    uint64_t getStolenJobs() const { return _stolen.load(std::memory_order_relaxed); }
+
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+    };
+
+    template<typename F>
+    void splitRange(size_t begin, size_t end, size_t grain, F& f, JobCounter& counter) {
+        while (end - begin > grain) {
+            const size_t middle = begin + (end - begin) / 2;
+            submit([this, middle, end, grain, &f, &counter]() { splitRange(middle, end, grain, f, counter); }, counter);
+            end = middle;
+        }
+        f(begin, end);
+    }
+
+    void run(size_t index);
+    void execute(Job* job);
+
+    // Own deque first, then the injection queue, then the other workers
+    Job* findJob(size_t index);
+
+    void wake();
+
+private:
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::atomic<bool> _stop {false};
+
+    // Jobs submitted from outside the pool
+    std::mutex _injectionMutex;
+    std::deque<Job*> _injection;
+    std::atomic<size_t> _injectionSize {0};
+
+    // Bumped on every submit, idle workers sleep on it
+    std::atomic<uint32_t> _signal {0};
+    std::atomic<uint32_t> _sleeping {0};
+
+    // Bumped on every job done, threads with nothing to run in wait sleep on it
+    std::atomic<uint32_t> _completed {0};
+    std::atomic<uint32_t> _waiting {0};
+
+    std::atomic<uint64_t> _executed {0};
+    std::atomic<uint64_t> _stolen {0};
+};
+
+} // namespace soul
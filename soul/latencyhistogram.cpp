@@ -0,0 +1,42 @@
+#include "latencyhistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace soul;
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i)
+        _counts[i] += other._counts[i];
+    _count += other._count;
+    _sum += other._sum;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double percent) const {
+    if (_count == 0)
+        return std::chrono::nanoseconds(0);
+
+    // Rank of the value, at least the first one. 99.9 is not exact in binary,
+    // the epsilon keeps 99.9% of 1000 values at rank 999 instead of 1000.
+    const double clamped = std::clamp(percent, 0.0, 100.0);
+    const double rankValue = std::ceil(clamped / 100.0 * static_cast<double>(_count) - 1e-6);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(rankValue));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += _counts[i];
+        if (seen >= rank)
+            return std::chrono::nanoseconds(std::min(highestValueOf(i), _max));
+    }
+    return std::chrono::nanoseconds(_max);
+}
+
+void LatencyHistogram::reset() {
+    _counts.fill(0);
+    _count = 0;
+    _sum = 0;
+    _min = UINT64_MAX;
+    _max = 0;
+}
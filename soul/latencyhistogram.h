@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+
+namespace soul {
+
+/**
+ * @brief Latency histogram with log-linear buckets (HDR histogram layout).
+ * Values are nanoseconds. Each power of two is split in SUB_BUCKET_COUNT linear
+ * sub-buckets, so any value is kept with a relative error below 1 / SUB_BUCKET_COUNT (0.8%),
+ * from 1 ns up to MAX_VALUE (about 18 minutes), larger values are clamped.
+ * Recording is O(1) (a bit scan, a shift and an increment) and never allocates.
+ * The histogram is not synchronized: use one per thread and merge them.
+ */
+class LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 7;
+    static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    void record(uint64_t nanoseconds) {
+        const uint64_t value = nanoseconds < MAX_VALUE ? nanoseconds : MAX_VALUE;
+        _counts[indexOf(value)]++;
+        _count++;
+        _sum += value;
+        _min = value < _min ? value : _min;
+        _max = value > _max ? value : _max;
+    }
+
+    void record(std::chrono::nanoseconds duration) {
+        record(duration.count() > 0 ? static_cast<uint64_t>(duration.count()) : 0);
+    }
+
+    // Add the values of another histogram, as if they were recorded here
+    void merge(const LatencyHistogram& other);
+
+    // Value at the percentile [0, 100], the upper bound of its bucket clamped to max()
+    std::chrono::nanoseconds percentile(double percent) const;
+
+    std::chrono::nanoseconds min() const { return std::chrono::nanoseconds(_count ? _min : 0); }
+    std::chrono::nanoseconds max() const { return std::chrono::nanoseconds(_max); }
+    std::chrono::nanoseconds mean() const { return std::chrono::nanoseconds(_count ? _sum / _count : 0); }
+    uint64_t count() const { return _count; }
+
+    void reset();
+
+    // Bucket of a value: linear below 2 * SUB_BUCKET_COUNT, then SUB_BUCKET_COUNT per power of two
+    static constexpr size_t indexOf(uint64_t value) {
+        const uint32_t width = static_cast<uint32_t>(std::bit_width(value));
+        const uint32_t shift = width > SUB_BUCKET_BITS + 1 ? width - SUB_BUCKET_BITS - 1 : 0;
+        return static_cast<size_t>(shift) * SUB_BUCKET_COUNT + static_cast<size_t>(value >> shift);
+    }
+
+    // Largest value of a bucket
+    static constexpr uint64_t highestValueOf(size_t index) {
+        if (index < 2 * SUB_BUCKET_COUNT)
+            return index;
+        const uint32_t shift = static_cast<uint32_t>(index / SUB_BUCKET_COUNT) - 1;
+        const uint64_t sub = index - static_cast<size_t>(shift) * SUB_BUCKET_COUNT;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> _counts {};
+    uint64_t _count {0};
+    uint64_t _sum {0};
+    uint64_t _min {UINT64_MAX};
+    uint64_t _max {0};
+};
+
+static_assert(LatencyHistogram::indexOf(LatencyHistogram::MAX_VALUE) == LatencyHistogram::BUCKET_COUNT - 1);
+static_assert(LatencyHistogram::highestValueOf(LatencyHistogram::indexOf(1000)) >= 1000);
+
+} // namespace soul
@@ -5,7 +5,9 @@
 #include "logger.h"
 #include "datetime.h"
 
+#include <algorithm>
 #include <iostream>
+#include <filesystem>
 
 using namespace soul;
 
@@ -16,9 +18,12 @@ LoggerConsole::LoggerConsole(const LOG_LEVEL level) : ILogger(level) {}
 LoggerConsole::~LoggerConsole() {}
 
 void LoggerConsole::write(const LOG_LEVEL level, const std::string& s) {
+    // Serialise the lines of all the threads sharing the console
+    static std::mutex consoleMutex;
+    thread_local std::string line;
 
-    std::string color_code;
-    std::string reset_code = "\033[0m";
+    const char* color_code = "";
+    const char* reset_code = "\033[0m";
 
     // using the X Macro
     switch (level) {
@@ -28,42 +33,334 @@ void LoggerConsole::write(const LOG_LEVEL level, const std::string& s) {
         default: color_code = ""; break;
     }
 
-    auto level_code = std::format("[{}, {}] ", getLogLevelString(level), DateTime().timeToString());
+    // Whole line built in the thread staging buffer, written in one call
+    char time[DateTime::MAX_FORMAT_SIZE];
+    const std::string_view timeView(time, DateTime().formatTimeTo(time));
+    line.clear();
+    std::format_to(std::back_inserter(line), "{}[{}, {}] {}{}\n", 
+        color_code, getLogLevelString(level), timeView, s, reset_code);
 
-    auto str = color_code + level_code + s + reset_code;
+    std::lock_guard<std::mutex> lock(consoleMutex);
+    std::cout.write(line.data(), static_cast<std::streamsize>(line.size()));
+    std::cout.flush();
+}
+
+LoggerFile::LoggerFile(const LOG_LEVEL level, const std::string& fileName, const LoggerFileOptions& options) 
+    : ILogger(level), fileName_(fileName), options_(options) {
+
+    buffer_.reserve(options_.bufferSize);
+    openTime_ = std::chrono::steady_clock::now();
+    lastFlush_ = openTime_;
+
+    open();
+
+    if (options_.flushInterval.count() > 0)
+        flusher_ = std::thread([this]() { flushLoop(); });
+}
 
-    std::cout << str << std::endl;
+LoggerFile::~LoggerFile() {
+    if (flusher_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopFlusher_ = true;
+        }
+        flushCondition_.notify_one();
+        flusher_.join();
+    }
+
+    // A failed rotation must not escape the destructor, the pending lines are lost
+    try {
+        flush();
+    } catch (...) {
+    }
 }
 
-LoggerFile::LoggerFile(const LOG_LEVEL level, const std::string& fileName) 
-    : ILogger(level) {
+void LoggerFile::flushLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopFlusher_) {
+        flushCondition_.wait_for(lock, options_.flushInterval);
+        if (stopFlusher_ || buffer_.empty())
+            continue;
+        if (std::chrono::steady_clock::now() - lastFlush_ < options_.flushInterval)
+            continue;
 
-    fileName_ = fileName;
+        // A failed rotation is retried at the next flush
+        try {
+            flushLocked();
+        } catch (...) {
+        }
+    }
+}
 
-    std::ofstream myLog(fileName_.c_str());
+void LoggerFile::open(std::ios::openmode mode) {
+    std::ofstream myLog(fileName_.c_str(), mode);
     file_ = std::move(myLog);
 
     if (!file_)
         throw LoggerException("Error: The log file was not opened.");
 
+    // Appending to the same file: the size limit applies again from here
+    fileSize_ = 0;
+    fileDate_ = DateTime().year_month_day();
+
     // File is opened
-    file_ << "EDEN Log file." << std::endl;
+    if (!(mode & std::ios::app))
+        buffer_.append("EDEN Log file.\n");
 }
 
-LoggerFile::~LoggerFile() {}
-
 void LoggerFile::write(const LOG_LEVEL level, const std::string& s) {
-    auto level_code = std::format("[{}, {}] ", getLogLevelString(level), DateTime().timeToString());
-    auto str =  level_code + s;
+    thread_local std::string line;
+
+    // The line is staged by the calling thread and appended as a whole
+    const DateTime now;
+    char date[DateTime::MAX_FORMAT_SIZE];
+    char time[DateTime::MAX_FORMAT_SIZE];
+    const std::string_view dateView(date, now.formatTo(date));
+    const std::string_view timeView(time, now.formatTimeTo(time));
+    line.clear();
+    std::format_to(std::back_inserter(line), "{}: [{}, {}] {}\n", 
+        dateView, getLogLevelString(level), timeView, s);
+
+    std::lock_guard<std::mutex> lock(mutex_);
 
-    file_ << DateTime().toString() << ": " << str << std::endl;
+    buffer_.append(line);
+    stats_.linesWritten++;
+
+    // Batch the writes: only hit the disk when the buffer is full or too old
+    if (buffer_.size() >= options_.bufferSize 
+        || std::chrono::steady_clock::now() - lastFlush_ >= options_.flushInterval) {
+        flushLocked();
+    }
 }
 
+void LoggerFile::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushLocked();
+}
+
+void LoggerFile::flushLocked() {
+    const auto start = std::chrono::steady_clock::now();
+    lastFlush_ = start;
+
+    if (options_.rotateDaily && fileDate_ != DateTime().year_month_day()) {
+        // Pending lines belong to the day that just ended
+        rotateLocked();
+    }
+
+    if (buffer_.empty())
+        return;
+
+    file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    file_.flush();
+
+    fileSize_ += buffer_.size();
+    stats_.bytesWritten += buffer_.size();
+    stats_.flushCount++;
+    buffer_.clear();
+
+    stats_.flushTime += std::chrono::steady_clock::now() - start;
+
+    if (options_.maxFileSize > 0 && fileSize_ >= options_.maxFileSize)
+        rotateLocked();
+}
+
+std::string LoggerFile::rotatedFileName() const {
+    const std::filesystem::path path(fileName_);
+
+    // e.g. goku.log -> goku.20250301.1.log
+    for (size_t index = 1; ; ++index) {
+        auto rotated = path.parent_path() / std::format("{}.{}.{}{}", 
+            path.stem().string(), fileDate_, index, path.extension().string());
+
+        if (!std::filesystem::exists(rotated))
+            return rotated.string();
+    }
+}
+
+void LoggerFile::rotateLocked() {
+    // Write what is left in the buffer to the file being rotated
+    if (!buffer_.empty()) {
+        file_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        stats_.bytesWritten += buffer_.size();
+        stats_.flushCount++;
+        buffer_.clear();
+    }
+    file_.close();
+
+    const auto rotated = rotatedFileName();
+    std::error_code ec;
+    std::filesystem::rename(fileName_, rotated, ec);
+    if (ec) {
+        // The current file was not moved away, truncating it would lose it
+        stats_.rotationFailures++;
+        open(std::ios::out | std::ios::app);
+        return;
+    }
+    history_.push_back(rotated);
+
+    // Keep only the most recent files
+    while (options_.maxHistory > 0 && history_.size() > options_.maxHistory) {
+        std::filesystem::remove(history_.front(), ec);
+        history_.pop_front();
+    }
+
+    stats_.rotationCount++;
+
+    open();
+}
+
+LoggerFileStats LoggerFile::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    LoggerFileStats stats = stats_;
+    stats.uptime = std::chrono::steady_clock::now() - openTime_;
+    return stats;
+}
+
+double LoggerFileStats::bytesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(uptime).count();
+    return seconds > 0.0 ? bytesWritten / seconds : 0.0;
+}
+
+double LoggerFileStats::linesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(uptime).count();
+    return seconds > 0.0 ? linesWritten / seconds : 0.0;
+}
+
+double LoggerFileStats::diskBytesPerSecond() const {
+    const double seconds = std::chrono::duration<double>(flushTime).count();
+    return seconds > 0.0 ? bytesWritten / seconds : 0.0;
+}
+
+std::array<LoggerManager::ReaderSlot, LoggerManager::MAX_READER_SLOTS> LoggerManager::s_readerSlots {};
+std::atomic<uint64_t> LoggerManager::s_unslottedReaders {0};
+
 void LoggerManager::addLogger(shared_ptr<ILogger> logger) {
-    // loggers_.push_back(std::move(logger));
-    loggers.push_back(logger);
+    std::lock_guard<std::mutex> lock(_sinksMutex);
+
+    auto sinks = _current ? std::make_unique<SinkList>(*_current) : std::make_unique<SinkList>();
+    sinks->push_back(std::move(logger));
+    publish(std::move(sinks));
+}
+
+void LoggerManager::removeLogger(const shared_ptr<ILogger>& logger) {
+    std::lock_guard<std::mutex> lock(_sinksMutex);
+
+    if (!_current)
+        return;
+
+    auto sinks = std::make_unique<SinkList>(*_current);
+    std::erase(*sinks, logger);
+    publish(std::move(sinks));
+}
+
+size_t LoggerManager::getRetiredSinkLists() {
+    std::lock_guard<std::mutex> lock(_sinksMutex);
+    return _retired.size();
+}
+
+void LoggerManager::publish(std::unique_ptr<const SinkList> sinks) {
+    // Loggers already iterating the previous list are unaffected
+    _sinks.store(sinks.get(), std::memory_order_seq_cst);
+    std::swap(_current, sinks);
+
+    // A reader holding the previous list announced an epoch up to this one
+    if (sinks)
+        _retired.emplace_back(_epoch.fetch_add(1, std::memory_order_seq_cst), std::move(sinks));
+    collectRetired();
+}
+
+void LoggerManager::collectRetired() {
+    if (_retired.empty() || s_unslottedReaders.load(std::memory_order_seq_cst) > 0)
+        return;
+
+    uint64_t oldest = std::numeric_limits<uint64_t>::max();
+    for (const ReaderSlot& slot : s_readerSlots) {
+        const uint64_t epoch = slot.epoch.load(std::memory_order_seq_cst);
+        if (epoch != 0)
+            oldest = std::min(oldest, epoch);
+    }
+    std::erase_if(_retired, [oldest](const auto& retired) { return retired.first < oldest; });
+}
+
+LoggerManager::ReaderSlot* LoggerManager::readerSlot() {
+    struct ThreadSlot {
+        ReaderSlot* slot {nullptr};
+        bool claimed {false};
+        ~ThreadSlot() {
+            if (slot)
+                slot->taken.store(false, std::memory_order_release);
+        }
+    };
+    thread_local ThreadSlot thread;
+
+    if (!thread.claimed) {
+        thread.claimed = true;
+        for (ReaderSlot& slot : s_readerSlots) {
+            bool taken = false;
+            if (slot.taken.compare_exchange_strong(taken, true, std::memory_order_acquire)) {
+                thread.slot = &slot;
+                break;
+            }
+        }
+    }
+    return thread.slot;
 }
 
 void LoggerManager::showInstanceAddress() const {
     std::cout << "LoggerManager instance: " << this << std::endl;
-}
\ No newline at end of file
+}
+
+LogCategory LoggerManager::registerCategory(string_view name, LOG_LEVEL level) {
+    std::lock_guard<std::mutex> lock(_categoriesMutex);
+
+    const size_t count = _categoryCount.load(std::memory_order_relaxed);
+    for (size_t id = 0; id < count; ++id) {
+        if (_categoryNames[id] == name)
+            return LogCategory{static_cast<uint8_t>(id)};
+    }
+
+    if (count >= MAX_LOG_CATEGORIES)
+        throw LoggerException(std::format("Error: Too many log categories, cannot register {}.", name));
+
+    const LogCategory category{static_cast<uint8_t>(count)};
+    _categoryNames[count] = string(name);
+    _categoryLevels[count].store(level, std::memory_order_relaxed);
+    _categoryEnabled[count].store(true, std::memory_order_relaxed);
+    updateCategoryMasks(category);
+
+    _categoryCount.store(count + 1, std::memory_order_release);
+    return category;
+}
+
+void LoggerManager::setCategoryLevel(LogCategory category, LOG_LEVEL level) {
+    std::lock_guard<std::mutex> lock(_categoriesMutex);
+    _categoryLevels[category.id].store(level, std::memory_order_relaxed);
+    updateCategoryMasks(category);
+}
+
+LOG_LEVEL LoggerManager::getCategoryLevel(LogCategory category) const {
+    return _categoryLevels[category.id].load(std::memory_order_relaxed);
+}
+
+void LoggerManager::setCategoryEnabled(LogCategory category, bool enabled) {
+    std::lock_guard<std::mutex> lock(_categoriesMutex);
+    _categoryEnabled[category.id].store(enabled, std::memory_order_relaxed);
+    updateCategoryMasks(category);
+}
+
+bool LoggerManager::isCategoryEnabled(LogCategory category) const {
+    return _categoryEnabled[category.id].load(std::memory_order_relaxed);
+}
+
+void LoggerManager::updateCategoryMasks(LogCategory category) {
+    const uint64_t bit = uint64_t{1} << category.id;
+    const auto level = static_cast<size_t>(_categoryLevels[category.id].load(std::memory_order_relaxed));
+    const bool enabled = _categoryEnabled[category.id].load(std::memory_order_relaxed);
+
+    for (size_t l = 0; l < LOG_LEVEL_COUNT; ++l) {
+        if (enabled && l >= level)
+            _categoryMasks[l].fetch_or(bit, std::memory_order_relaxed);
+        else
+            _categoryMasks[l].fetch_and(~bit, std::memory_order_relaxed);
+    }
+}
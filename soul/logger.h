@@ -4,11 +4,21 @@
 #include "singleton.h"
 
 #include <vector>
+#include <deque>
 #include <memory>
 #include <string_view>
 #include <fstream>
 #include <exception>
 #include <format>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iterator>
+#include <array>
+#include <limits>
 
 using namespace std;
 
@@ -21,6 +31,13 @@ enum class LOG_LEVEL {
 #undef X
 };
 
+// Number of log levels, used to index per-level tables
+inline constexpr size_t LOG_LEVEL_COUNT = 0
+#define X(name, color, str) + 1
+    LOG_LEVELS
+#undef X
+    ;
+
 inline const char* getLogLevelString(LOG_LEVEL level) {
     switch (level) {
 #define X(name, color, str) case LOG_LEVEL::name: return str;
@@ -43,6 +60,45 @@ private:
     string message_;
 };
 
+/**
+ * State of a rate-limited log call site, declared static next to the call.
+ * Counters use relaxed load/store instead of read-modify-write operations:
+ * under contention a few messages may pass or be dropped, in exchange the 
+ * rejected calls cost a load and a branch.
+ */
+struct LogSite {
+    std::atomic<uint64_t> count {0};
+    std::atomic<int64_t>  lastNs {std::numeric_limits<int64_t>::min()};
+
+    // True for the 1st, (n+1)th, (2n+1)th... call
+    bool everyN(uint64_t n) {
+        const auto c = count.load(std::memory_order_relaxed);
+        count.store(c + 1, std::memory_order_relaxed);
+        return n <= 1 || c % n == 0;
+    }
+
+    // True for the first n calls
+    bool firstN(uint64_t n) {
+        const auto c = count.load(std::memory_order_relaxed);
+        if (c >= n)
+            return false;
+        count.store(c + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // True if the previous accepted call is older than the interval
+    bool everyInterval(std::chrono::milliseconds interval) {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        const int64_t last = lastNs.load(std::memory_order_relaxed);
+        if (last != std::numeric_limits<int64_t>::min() 
+            && now - last < std::chrono::duration_cast<std::chrono::nanoseconds>(interval).count())
+            return false;
+        lastNs.store(now, std::memory_order_relaxed);
+        return true;
+    }
+};
+
 // Abstract Logger class
 class ILogger {
 
@@ -50,14 +106,15 @@ public:
     ILogger(const LOG_LEVEL level);
     virtual ~ILogger() = default;
 
-    void setLevel(const LOG_LEVEL level) { level_ = level; }
+    void setLevel(const LOG_LEVEL level) { level_.store(level, std::memory_order_relaxed); }
 
-    LOG_LEVEL getLevel() const { return level_; }
+    LOG_LEVEL getLevel() const { return level_.load(std::memory_order_relaxed); }
 
+    // Called concurrently from any thread: a line must be written in one piece
     virtual void write(const LOG_LEVEL level, const string& s) = 0;
 
 private:
-    LOG_LEVEL     level_; 
+    std::atomic<LOG_LEVEL>  level_; 
 };
 
 // Simple Logger for console output 
@@ -71,18 +128,103 @@ public:
     void write(const LOG_LEVEL level, const string& s) override;
 };
 
-// Logger with simple file output 
+/**
+ * Options of the file logger.
+ * Lines are accumulated in memory and written to disk in batches,
+ * either when the buffer is full or when the flush interval has elapsed.
+ */
+struct LoggerFileOptions {
+    // Size of the in-memory buffer, flushed to disk once reached
+    size_t bufferSize {256 * 1024};
+    // Maximum time a line can wait in the buffer, a background thread flushes
+    // the lines left after the last write; 0 writes every line right away
+    std::chrono::milliseconds flushInterval {1000};
+    // Rotate the file once it reaches this size in bytes, 0 disables it
+    uint64_t maxFileSize {0};
+    // Rotate the file when the date (DateTime::year_month_day) changes
+    bool rotateDaily {false};
+    // Number of rotated files kept on disk, 0 keeps all of them
+    size_t maxHistory {5};
+};
+
+/**
+ * Statistics of the file logger, used to report its throughput.
+ */
+struct LoggerFileStats {
+    uint64_t linesWritten {0};
+    uint64_t bytesWritten {0};
+    uint64_t flushCount {0};
+    uint64_t rotationCount {0};
+    // Rotations abandoned because the file could not be renamed, the file keeps growing
+    uint64_t rotationFailures {0};
+    // Time spent writing the buffer to disk
+    std::chrono::nanoseconds flushTime {0};
+    // Time since the logger was opened
+    std::chrono::nanoseconds uptime {0};
+
+    // Bytes per second over the lifetime of the logger
+    double bytesPerSecond() const;
+    // Lines per second over the lifetime of the logger
+    double linesPerSecond() const;
+    // Bytes per second while writing to disk
+    double diskBytesPerSecond() const;
+};
+
+// Logger with buffered and rotating file output
 class LoggerFile : public ILogger {
 
 public:
-    LoggerFile(const LOG_LEVEL level, const string& fileName);
+    LoggerFile(const LOG_LEVEL level, const string& fileName, const LoggerFileOptions& options = {});
     virtual ~LoggerFile();
 
     void write(const LOG_LEVEL level, const string& s) override;
 
+    // Write the pending lines to disk, to be called from crash/terminate handlers
+    void flush();
+
+    LoggerFileStats getStats() const;
+
+    const string& getFileName() const { return fileName_; }
+
+private:
+    // Truncates the file unless mode has std::ios::app
+    void open(std::ios::openmode mode = std::ios::out);
+    void flushLocked();
+    void rotateLocked();
+    string rotatedFileName() const;
+
+    // Body of the flusher thread, flushes the buffer once it is older than the interval
+    void flushLoop();
+
 private:
-    ofstream   file_;
-    string     fileName_;
+    ofstream            file_;
+    string              fileName_;
+    LoggerFileOptions   options_;
+    LoggerFileStats     stats_;
+
+    mutable std::mutex  mutex_;
+    string              buffer_;
+    uint64_t            fileSize_ {0};
+    // Date of the current file, used for daily rotation
+    string              fileDate_;
+    // Rotated files, oldest first
+    std::deque<string>  history_;
+
+    std::chrono::steady_clock::time_point openTime_;
+    std::chrono::steady_clock::time_point lastFlush_;
+
+    // Periodic flush, protected by the mutex
+    std::condition_variable flushCondition_;
+    bool                stopFlusher_ {false};
+    std::thread         flusher_;
+};
+
+/**
+ * Log category (channel) of a subsystem, registered once by name in the LoggerManager.
+ * The id is the index of the category bit in the per-level category masks.
+ */
+struct LogCategory {
+    uint8_t id {0};
 };
 
 /**
@@ -94,10 +236,19 @@ class LoggerManager : public SingletonT<LoggerManager> {
     MAKE_SINGLETON(LoggerManager)
 
 public:
+    // Sinks are published as an immutable list, replaced on every change (copy-on-write)
+    // and freed once no log call can still read it
+    using SinkList = vector<shared_ptr<ILogger>>;
+
     void showInstanceAddress() const;
 
     void addLogger(shared_ptr<ILogger> logger);
 
+    void removeLogger(const shared_ptr<ILogger>& logger);
+
+    // Replaced sink lists not freed yet, a log call may still read them
+    size_t getRetiredSinkLists();
+
     template<typename... Args>
     string dynaWriteGet(string_view rt_fmt_str, Args&&... args) {
         
@@ -107,18 +258,32 @@ public:
     template<typename... Args>
     void log(string_view rt_fmt_str, Args&&... args) {
 
-        auto str = vformat(rt_fmt_str, std::make_format_args(args...));
+        const SinkGuard guard(*this);
+        const SinkList* sinks = guard.sinks();
+        if (sinks == nullptr)
+            return;
+
+        auto& str = formatStaged(rt_fmt_str, args...);
         
-        for (auto& logger : loggers)
+        for (auto& logger : *sinks)
             logger->write(LOG_LEVEL::LOG_INFO, str);
     }
 
     template<typename... Args>
     void logLevel(LOG_LEVEL level, string_view rt_fmt_str, Args&&... args) {
 
-        auto str = vformat(rt_fmt_str, std::make_format_args(args...));
+        const SinkGuard guard(*this);
+        const SinkList* sinks = guard.sinks();
+        if (sinks == nullptr)
+            return;
+
+        // Nothing is formatted when no sink takes the level or the message is sampled out
+        if (!isEnabled(*sinks, level) || !isSampled(level))
+            return;
 
-        for (auto& logger : loggers) {
+        auto& str = formatStaged(rt_fmt_str, args...);
+
+        for (auto& logger : *sinks) {
             if (level >= logger->getLevel())
                 logger->write(level, str);
         }
@@ -154,9 +319,244 @@ public:
         logLevel(LOG_LEVEL::LOG_ERROR, rt_fmt_str, std::forward<Args>(args)...);
     }
 
+    // Log the 1st call of every n calls of the site
+    template<typename... Args>
+    void logEveryN(LogSite& site, uint64_t n, LOG_LEVEL level, string_view rt_fmt_str, Args&&... args) {
+
+        if (site.everyN(n))
+            logLevel(level, rt_fmt_str, std::forward<Args>(args)...);
+    }
+
+    // Log the first n calls of the site only
+    template<typename... Args>
+    void logFirstN(LogSite& site, uint64_t n, LOG_LEVEL level, string_view rt_fmt_str, Args&&... args) {
+
+        if (site.firstN(n))
+            logLevel(level, rt_fmt_str, std::forward<Args>(args)...);
+    }
+
+    // Log at most one call of the site per interval
+    template<typename... Args>
+    void logEveryInterval(LogSite& site, std::chrono::milliseconds interval, LOG_LEVEL level, string_view rt_fmt_str, Args&&... args) {
+
+        if (site.everyInterval(interval))
+            logLevel(level, rt_fmt_str, std::forward<Args>(args)...);
+    }
+
+    /**
+     * Messages of a category are filtered by the level of the category only
+     * (sink levels apply to messages without category): a single subsystem
+     * can be traced at debug level while the others stay at info level.
+     * The check is one load and a bit test, done before any formatting.
+     */
+    template<typename... Args>
+    void log(LogCategory category, LOG_LEVEL level, string_view rt_fmt_str, Args&&... args) {
+
+        if (!isEnabled(category, level))
+            return;
+
+        const SinkGuard guard(*this);
+        const SinkList* sinks = guard.sinks();
+        if (sinks == nullptr || !isSampled(level))
+            return;
+
+        auto& str = formatStaged(categoryName(category), rt_fmt_str, args...);
+
+        for (auto& logger : *sinks)
+            logger->write(level, str);
+    }
+
+    static constexpr size_t MAX_LOG_CATEGORIES = 64;
+
+    // Register a category, or return the existing one with the same name
+    LogCategory registerCategory(string_view name, LOG_LEVEL level = LOG_LEVEL::LOG_INFO);
+
+    // Messages of the category below the level are discarded
+    void setCategoryLevel(LogCategory category, LOG_LEVEL level);
+
+    LOG_LEVEL getCategoryLevel(LogCategory category) const;
+
+    // A disabled category discards all its messages, its level is kept
+    void setCategoryEnabled(LogCategory category, bool enabled);
+
+    bool isCategoryEnabled(LogCategory category) const;
+
+    // Number of categories registered, their ids go from 0 to count - 1
+    size_t getCategoryCount() const { return _categoryCount.load(std::memory_order_acquire); }
+
+    const string& categoryName(LogCategory category) const { return _categoryNames[category.id]; }
+
+    bool isEnabled(LogCategory category, LOG_LEVEL level) const {
+        return (_categoryMasks[static_cast<size_t>(level)].load(std::memory_order_relaxed) >> category.id) & 1u;
+    }
+
+    // True if at least one sink takes messages of the level
+    bool isEnabled(LOG_LEVEL level) const {
+        const SinkGuard guard(*this);
+        const SinkList* sinks = guard.sinks();
+        return sinks != nullptr && isEnabled(*sinks, level);
+    }
+
+    // Keep one message out of n for the level, 1 keeps them all
+    void setSamplingRate(LOG_LEVEL level, uint32_t n) {
+        _sampling[static_cast<size_t>(level)].store(n == 0 ? 1 : n, std::memory_order_relaxed);
+    }
+
+    uint32_t getSamplingRate(LOG_LEVEL level) const {
+        const uint32_t n = _sampling[static_cast<size_t>(level)].load(std::memory_order_relaxed);
+        return n == 0 ? 1 : n;
+    }
+
 private:
-    vector<shared_ptr<ILogger>>  loggers;
+    // Reader slot of a thread, on its own cache line so readers do not share any write
+    struct alignas(64) ReaderSlot {
+        // Epoch announced by the thread while it reads the sinks, 0 otherwise
+        std::atomic<uint64_t> epoch {0};
+        std::atomic<bool>     taken {false};
+    };
+
+    static constexpr size_t MAX_READER_SLOTS = 128;
+
+    // Slot of the calling thread, released when the thread exits, nullptr when all are taken
+    static ReaderSlot* readerSlot();
+
+    /**
+     * Pins the published sink list for the scope of a log call (epoch based reclamation):
+     * the thread announces the current epoch in its slot, then reads the list.
+     * A list replaced at epoch e is only freed once no slot announces an epoch <= e.
+     * Threads without a slot are counted instead, nothing is freed while there are some.
+     */
+    class SinkGuard {
+    public:
+        explicit SinkGuard(const LoggerManager& manager) : _slot(readerSlot()) {
+            if (_slot) {
+                // Nested in another log call of the thread: already pinned
+                _pinned = _slot->epoch.load(std::memory_order_relaxed) == 0;
+                if (_pinned)
+                    _slot->epoch.store(manager._epoch.load(std::memory_order_acquire), std::memory_order_seq_cst);
+            } else {
+                s_unslottedReaders.fetch_add(1, std::memory_order_seq_cst);
+            }
+            _sinks = manager._sinks.load(std::memory_order_seq_cst);
+        }
+
+        ~SinkGuard() {
+            if (!_slot)
+                s_unslottedReaders.fetch_sub(1, std::memory_order_release);
+            else if (_pinned)
+                _slot->epoch.store(0, std::memory_order_release);
+        }
+
+        SinkGuard(const SinkGuard&) = delete;
+        SinkGuard& operator=(const SinkGuard&) = delete;
+
+        const SinkList* sinks() const { return _sinks; }
+
+    private:
+        ReaderSlot*     _slot;
+        bool            _pinned {false};
+        const SinkList* _sinks {nullptr};
+    };
+
+    // Publishes the list and retires the previous one, under the sinks mutex
+    void publish(std::unique_ptr<const SinkList> sinks);
+
+    // Frees the retired lists no reader can still hold, under the sinks mutex
+    void collectRetired();
+
+    static bool isEnabled(const SinkList& sinks, LOG_LEVEL level) {
+        for (auto& logger : sinks) {
+            if (level >= logger->getLevel())
+                return true;
+        }
+        return false;
+    }
+
+    bool isSampled(LOG_LEVEL level) {
+        const size_t index = static_cast<size_t>(level);
+        const uint32_t rate = _sampling[index].load(std::memory_order_relaxed);
+        if (rate <= 1)
+            return true;
+        return _sampled[index].fetch_add(1, std::memory_order_relaxed) % rate == 0;
+    }
+
+    // Format in the staging buffer of the calling thread, reused from one call to the next.
+    // Sinks must not log through the manager from their write method.
+    template<typename... Args>
+    static string& formatStaged(string_view rt_fmt_str, Args&... args) {
+        thread_local string staging;
+
+        staging.clear();
+        std::vformat_to(std::back_inserter(staging), rt_fmt_str, std::make_format_args(args...));
+        return staging;
+    }
+
+    // Same as above, with the category as prefix
+    template<typename... Args>
+    static string& formatStaged(const string& category, string_view rt_fmt_str, Args&... args) {
+        thread_local string staging;
+
+        staging.clear();
+        staging.append("[").append(category).append("] ");
+        std::vformat_to(std::back_inserter(staging), rt_fmt_str, std::make_format_args(args...));
+        return staging;
+    }
+
+    // Set the bits of the category in the masks from its level and enabled state
+    void updateCategoryMasks(LogCategory category);
+
+private:
+    // Current sinks, read without locking by the log methods
+    std::atomic<const SinkList*>            _sinks {nullptr};
+    // Owner of the current list
+    std::unique_ptr<const SinkList>         _current;
+    // Bumped each time a list is replaced, starts at 1 as 0 marks an idle reader
+    std::atomic<uint64_t>                   _epoch {1};
+    // Lists replaced at an epoch, freed with their removed sinks once no reader holds them
+    vector<std::pair<uint64_t, std::unique_ptr<const SinkList>>> _retired;
+    // Serialises addLogger/removeLogger
+    std::mutex                              _sinksMutex;
+
+    // Shared by all the managers, a thread keeps its slot until it exits
+    static std::array<ReaderSlot, MAX_READER_SLOTS> s_readerSlots;
+    static std::atomic<uint64_t>            s_unslottedReaders;
+    // One message kept out of n, per level
+    std::array<std::atomic<uint32_t>, LOG_LEVEL_COUNT> _sampling {};
+    std::array<std::atomic<uint64_t>, LOG_LEVEL_COUNT> _sampled {};
+
+    // Bit n of the mask of a level is set when category n logs at that level
+    std::array<std::atomic<uint64_t>, LOG_LEVEL_COUNT> _categoryMasks {};
+    // Names are written once before the count is published, never modified after
+    std::array<string, MAX_LOG_CATEGORIES>              _categoryNames;
+    std::array<std::atomic<LOG_LEVEL>, MAX_LOG_CATEGORIES> _categoryLevels {};
+    std::array<std::atomic<bool>, MAX_LOG_CATEGORIES>   _categoryEnabled {};
+    std::atomic<size_t>                                 _categoryCount {0};
+    // Serialises the changes of the categories
+    mutable std::mutex                                  _categoriesMutex;
 };
 
+/**
+ * Rate-limited logging for per-frame code, each expansion owns its call site state.
+ * e.g. SOUL_LOG_EVERY_N(logManager, 100, LOG_LEVEL::LOG_DEBUG, "Fireball {} is dead", id);
+ * The arguments are only evaluated when the message passes the limit.
+ */
+#define SOUL_LOG_EVERY_N(logger, n, level, ...) \
+    do { \
+        static soul::LogSite soulLogSite_; \
+        if (soulLogSite_.everyN(n)) (logger).logLevel(level, __VA_ARGS__); \
+    } while (0)
+
+#define SOUL_LOG_FIRST_N(logger, n, level, ...) \
+    do { \
+        static soul::LogSite soulLogSite_; \
+        if (soulLogSite_.firstN(n)) (logger).logLevel(level, __VA_ARGS__); \
+    } while (0)
+
+#define SOUL_LOG_EVERY_INTERVAL(logger, interval, level, ...) \
+    do { \
+        static soul::LogSite soulLogSite_; \
+        if (soulLogSite_.everyInterval(interval)) (logger).logLevel(level, __VA_ARGS__); \
+    } while (0)
+
 
 } // namespace soul
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace soul {
+
+/**
+ * @brief Multiple producers, single consumer queue.
+ * Producers push on an intrusive stack with a compare and swap (Treiber stack), the consumer
+ * takes the whole stack with one exchange and reverses it, so items come out in push order
+ * for each producer. As the consumer never pops a single node there is no ABA problem.
+ * Pushing allocates the node, the queue itself never locks.
+ */
+template<typename T>
+class MpscQueue {
+public:
+    MpscQueue() = default;
+    ~MpscQueue() { drain([](T&&) {}); }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Any thread
+    void push(T value) {
+        Node* node = new Node {std::move(value), _head.load(std::memory_order_relaxed)};
+        while (!_head.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+    }
+
+    // Consumer only: calls f(T&&) on every item pushed so far, oldest first, returns the count
+    template<typename F>
+    size_t drain(F&& f) {
+        Node* node = _head.exchange(nullptr, std::memory_order_acquire);
+
+        // Newest first on the stack
+        Node* oldest = nullptr;
+        while (node) {
+            Node* next = node->next;
+            node->next = oldest;
+            oldest = node;
+            node = next;
+        }
+
+        size_t count = 0;
+        while (oldest) {
+            Node* next = oldest->next;
+            f(std::move(oldest->value));
+            delete oldest;
+            oldest = next;
+            ++count;
+        }
+        return count;
+    }
+
+    bool empty() const { return _head.load(std::memory_order_acquire) == nullptr; }
+
+private:
+    struct Node {
+        T value;
+        Node* next;
+    };
+
+    std::atomic<Node*> _head {nullptr};
+};
+
+} // namespace soul
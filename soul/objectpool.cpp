@@ -0,0 +1,66 @@
+#include "objectpool.h"
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <stdexcept>
+
+using namespace soul;
+
+BlockPool::BlockPool(size_t blockSize, size_t alignment, size_t slabBlocks, PoolGrowth growth)
+    : _alignment(std::max(alignment, alignof(FreeBlock))), _slabBlocks(std::max<size_t>(slabBlocks, 1)), _growth(growth) {
+    // A free block holds the link, every block of a slab keeps the alignment
+    const size_t size = std::max(blockSize, sizeof(FreeBlock));
+    _blockSize = (size + _alignment - 1) / _alignment * _alignment;
+}
+
+BlockPool::~BlockPool() {
+    for (const Slab& slab : _slabs)
+        ::operator delete[](slab.memory, std::align_val_t(_alignment));
+}
+
+void BlockPool::grow(size_t blocks) {
+    if (blocks == 0) {
+        switch (_growth) {
+            case PoolGrowth::Fixed:
+                if (!_slabs.empty())
+                    throw std::length_error(std::format("BlockPool: all the {} blocks are in use", _stats.capacity));
+                blocks = _slabBlocks;
+                break;
+            case PoolGrowth::Linear:
+                blocks = _slabBlocks;
+                break;
+            case PoolGrowth::Doubling:
+                blocks = std::max(_slabBlocks, _stats.capacity);
+                break;
+        }
+    }
+
+    std::byte* memory = static_cast<std::byte*>(::operator new[](blocks * _blockSize, std::align_val_t(_alignment)));
+    _slabs.push_back(Slab {memory, blocks});
+
+    // Linked in address order, so the first blocks given are contiguous
+    for (size_t i = blocks; i-- > 0;) {
+        FreeBlock* block = reinterpret_cast<FreeBlock*>(memory + i * _blockSize);
+        block->next = _free;
+        _free = block;
+    }
+    _stats.capacity += blocks;
+    _stats.slabs++;
+}
+
+void BlockPool::reserve(size_t blocks) {
+    const size_t available = _stats.capacity - _stats.live;
+    if (blocks > available)
+        grow(blocks - available);
+}
+
+bool BlockPool::owns(const void* p) const {
+    const std::byte* address = static_cast<const std::byte*>(p);
+    for (const Slab& slab : _slabs) {
+        if (!std::less<const std::byte*>()(address, slab.memory)
+            && std::less<const std::byte*>()(address, slab.memory + slab.blocks * _blockSize))
+            return (address - slab.memory) % _blockSize == 0;
+    }
+    return false;
+}
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace soul {
+
+// How a pool grows when its free list is empty
+enum class PoolGrowth {
+    // Never, acquire throws std::length_error when the pool is full
+    Fixed,
+    // A slab of the initial size
+    Linear,
+    // A slab as big as the whole pool
+    Doubling
+};
+
+struct ObjectPoolStats {
+    size_t capacity {0};
+    size_t live {0};
+    size_t peak {0};
+    size_t slabs {0};
+    uint64_t acquires {0};
+    uint64_t releases {0};
+
+    double occupancy() const { return capacity ? static_cast<double>(live) / static_cast<double>(capacity) : 0.0; }
+};
+
+/**
+ * @brief Pool of blocks of one size, carved from contiguous slabs.
+ * A free block holds the pointer to the next free one (intrusive free list), so allocate and
+ * deallocate are a pop and a push, and the slabs are only allocated when the free list is empty.
+ * The most recently freed block is given first, it is still warm in the cache.
+ * Slabs are only freed with the pool. Not synchronized.
+ */
+class BlockPool {
+public:
+    BlockPool(size_t blockSize, size_t alignment, size_t slabBlocks, PoolGrowth growth);
+    ~BlockPool();
+
+    BlockPool(const BlockPool&) = delete;
+    BlockPool& operator=(const BlockPool&) = delete;
+
+    void* allocate() {
+        if (!_free)
+            grow(0);
+        FreeBlock* block = _free;
+        _free = block->next;
+        _stats.acquires++;
+        if (++_stats.live > _stats.peak)
+            _stats.peak = _stats.live;
+        return block;
+    }
+
+    void deallocate(void* p) {
+        assert(owns(p) && "Block of another pool");
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = _free;
+        _free = block;
+        _stats.releases++;
+        _stats.live--;
+    }
+
+    // Grows until blocks are free without another slab, whatever the growth policy
+    void reserve(size_t blocks);
+
+    bool owns(const void* p) const;
+
+    size_t blockSize() const { return _blockSize; }
+    const ObjectPoolStats& stats() const { return _stats; }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    struct Slab {
+        std::byte* memory;
+        size_t blocks;
+    };
+
+    // Adds a slab of at least blocks blocks, the policy decides when 0
+    void grow(size_t blocks);
+
+private:
+    size_t _blockSize;
+    size_t _alignment;
+    size_t _slabBlocks;
+    PoolGrowth _growth;
+    FreeBlock* _free {nullptr};
+    std::vector<Slab> _slabs;
+    ObjectPoolStats _stats;
+};
+
+/**
+ * @brief Pool of objects of type T on a BlockPool.
+ * acquire() constructs an object in a free block and release() destroys it and frees the block, in O(1).
+ * acquireShared() returns a shared_ptr whose deleter releases the object, its control block comes
+ * from a second pool of the pool: once the pools are big enough, acquiring and releasing
+ * objects does not allocate at all. The pool must outlive its objects. Not synchronized.
+ */
+template<typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t slabSize = 64, PoolGrowth growth = PoolGrowth::Doubling)
+        : _objects(sizeof(T), alignof(T), slabSize, growth), _slabSize(slabSize), _growth(growth) {}
+
+    ~ObjectPool() {
+        assert(_objects.stats().live == 0 && "Objects still acquired");
+    }
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    template<typename... Args>
+    T* acquire(Args&&... args) {
+        void* block = _objects.allocate();
+        try {
+            return ::new (block) T(std::forward<Args>(args)...);
+        } catch (...) {
+            _objects.deallocate(block);
+            throw;
+        }
+    }
+
+    void release(T* object) {
+        if (!object)
+            return;
+        object->~T();
+        _objects.deallocate(object);
+    }
+
+    template<typename... Args>
+    std::shared_ptr<T> acquireShared(Args&&... args) {
+        T* object = acquire(std::forward<Args>(args)...);
+        // On failure the shared_ptr constructor calls the deleter
+        return std::shared_ptr<T>(object, Releaser {this}, ControlAllocator<T> {this});
+    }
+
+    void reserve(size_t count) { _objects.reserve(count); }
+
+    const ObjectPoolStats& stats() const { return _objects.stats(); }
+
+private:
+    struct Releaser {
+        ObjectPool* pool;
+        void operator()(T* object) const { pool->release(object); }
+    };
+
+    // Control blocks of the shared_ptrs, all of the same type so of the same size
+    template<typename U>
+    struct ControlAllocator {
+        using value_type = U;
+
+        template<typename V>
+        struct rebind {
+            using other = ControlAllocator<V>;
+        };
+
+        ObjectPool* pool;
+
+        explicit ControlAllocator(ObjectPool* p) : pool(p) {}
+        template<typename V>
+        ControlAllocator(const ControlAllocator<V>& other) : pool(other.pool) {}
+
+        U* allocate(size_t n) {
+            assert(n == 1);
+            (void)n;
+            return static_cast<U*>(pool->controlBlocks(sizeof(U), alignof(U)).allocate());
+        }
+        void deallocate(U* p, size_t) { pool->_controlBlocks->deallocate(p); }
+
+        template<typename V>
+        bool operator==(const ControlAllocator<V>& other) const { return pool == other.pool; }
+    };
+
+    BlockPool& controlBlocks(size_t size, size_t alignment) {
+        if (!_controlBlocks)
+            _controlBlocks.emplace(size, alignment, _slabSize, _growth);
+        assert(_controlBlocks->blockSize() >= size);
+        return *_controlBlocks;
+    }
+
+private:
+    BlockPool _objects;
+    std::optional<BlockPool> _controlBlocks;
+    size_t _slabSize;
+    PoolGrowth _growth;
+};
+
+} // namespace soul
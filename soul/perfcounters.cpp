@@ -0,0 +1,277 @@
+#include "perfcounters.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <format>
+
+#if defined(__linux__)
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+using namespace soul;
+
+namespace {
+
+#if defined(__linux__)
+
+struct PerfEventConfig {
+    uint32_t type;
+    uint64_t config;
+};
+
+// Same order as PerfEvent, cycles first as it leads the group
+constexpr std::array<PerfEventConfig, PERF_EVENT_COUNT> EVENT_CONFIGS {{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+}};
+
+int openEvent(const PerfEventConfig& event, int groupFd) {
+    perf_event_attr attr {};
+    attr.size = sizeof(attr);
+    attr.type = event.type;
+    attr.config = event.config;
+    attr.disabled = groupFd < 0 ? 1 : 0;
+    // User space only, the default perf_event_paranoid level allows it
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    // Calling thread, any CPU
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+}
+
+#endif
+
+// Multiplexed groups only run part of the time, extrapolate the delta over the enabled time
+uint64_t scaledDelta(uint64_t begin, uint64_t end, uint64_t enabled, uint64_t running) {
+    const uint64_t delta = end - begin;
+    if (running == 0 || running >= enabled)
+        return delta;
+    return static_cast<uint64_t>(static_cast<double>(delta) * static_cast<double>(enabled) / static_cast<double>(running));
+}
+
+} // namespace
+
+PerfCounterGroup::PerfCounterGroup() {
+    _fds.fill(-1);
+
+#if defined(__linux__)
+    uint8_t slot = 0;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i) {
+        const int fd = openEvent(EVENT_CONFIGS[i], _leader);
+        if (fd < 0) {
+            // Without cycles there is no group, other events may just be missing on this CPU
+            if (i == 0) {
+                _error = errno;
+                return;
+            }
+            continue;
+        }
+        if (i == 0)
+            _leader = fd;
+        _fds[i] = fd;
+        _slots[i] = slot++;
+        _supported |= 1u << i;
+    }
+
+    ioctl(_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#else
+    _error = ENOSYS;
+#endif
+}
+
+PerfCounterGroup::~PerfCounterGroup() {
+#if defined(__linux__)
+    // Members before the leader
+    for (size_t i = PERF_EVENT_COUNT; i-- > 0;) {
+        if (_fds[i] >= 0)
+            close(_fds[i]);
+    }
+#endif
+}
+
+bool PerfCounterGroup::read(PerfReading& reading) const {
+#if defined(__linux__)
+    if (_leader < 0)
+        return false;
+
+    // nr, time enabled, time running, then one value per opened event
+    uint64_t buffer[3 + PERF_EVENT_COUNT];
+    const ssize_t size = ::read(_leader, buffer, sizeof(buffer));
+    if (size < static_cast<ssize_t>(3 * sizeof(uint64_t)))
+        return false;
+
+    reading.enabled = buffer[1];
+    reading.running = buffer[2];
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+        reading.values[i] = (_supported & (1u << i)) ? buffer[3 + _slots[i]] : 0;
+    return true;
+#else
+    (void)reading;
+    return false;
+#endif
+}
+
+bool PerfCounters::isAvailable() {
+    std::call_once(_probeFlag, [this]() {
+        const PerfCounterGroup* group = threadGroup();
+        _available = group != nullptr;
+        if (_available) {
+            _status = "Hardware counters available";
+        } else {
+            const int error = threadZones()->group.error();
+            _status = std::format("perf_event_open failed ({}), timing only", std::strerror(error));
+        }
+    });
+    return _available;
+}
+
+std::string PerfCounters::getStatus() {
+    isAvailable();
+    return _status;
+}
+
+PerfCounters::ThreadOwner::~ThreadOwner() {
+    if (zones)
+        counters->unregisterThread(zones);
+}
+
+PerfCounters::ThreadZones* PerfCounters::threadZones() {
+    thread_local ThreadOwner owner;
+    if (!owner.zones) {
+        std::lock_guard<std::mutex> lock(_threadsMutex);
+        _threads.push_back(std::make_unique<ThreadZones>());
+        owner.counters = this;
+        owner.zones = _threads.back().get();
+    }
+    return owner.zones;
+}
+
+void PerfCounters::unregisterThread(ThreadZones* zones) {
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    auto it = std::find_if(_threads.begin(), _threads.end(), [zones](const auto& thread) {
+        return thread.get() == zones;
+    });
+    if (it == _threads.end())
+        return;
+
+    {
+        std::lock_guard<std::mutex> zonesLock(zones->mutex);
+        _exitedZones.insert(_exitedZones.end(), zones->zones.begin(), zones->zones.end());
+    }
+    // Closes the perf events of the thread
+    _threads.erase(it);
+}
+
+PerfCounterGroup* PerfCounters::threadGroup() {
+    ThreadZones* zones = threadZones();
+    return zones->group.isOpen() ? &zones->group : nullptr;
+}
+
+void PerfCounters::record(const char* name, const PerfReading& begin, const PerfReading& end, uint64_t items) {
+    const uint64_t enabled = end.enabled - begin.enabled;
+    const uint64_t running = end.running - begin.running;
+    // The group was never scheduled during the zone, nothing was counted
+    if (running == 0)
+        return;
+
+    ThreadZones* zones = threadZones();
+    std::lock_guard<std::mutex> lock(zones->mutex);
+
+    auto it = std::find_if(zones->zones.begin(), zones->zones.end(), [name](const PerfZoneStats& stats) {
+        return stats.name == name;
+    });
+    if (it == zones->zones.end()) {
+        zones->zones.push_back(PerfZoneStats{name, 0, 0, zones->group.supported(), {}});
+        it = zones->zones.end() - 1;
+    }
+
+    it->calls++;
+    it->items += items;
+    for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+        it->totals[i] += scaledDelta(begin.values[i], end.values[i], enabled, running);
+}
+
+void PerfCounters::accumulate(const std::vector<PerfZoneStats>& zones) {
+    for (const PerfZoneStats& zone : zones) {
+        auto it = std::find_if(_current.begin(), _current.end(), [&zone](const PerfZoneStats& stats) {
+            return stats.name == zone.name;
+        });
+        if (it == _current.end()) {
+            _current.push_back(zone);
+            continue;
+        }
+        it->calls += zone.calls;
+        it->items += zone.items;
+        it->supported &= zone.supported;
+        for (size_t i = 0; i < PERF_EVENT_COUNT; ++i)
+            it->totals[i] += zone.totals[i];
+    }
+}
+
+const std::vector<PerfZoneStats>& PerfCounters::endFrame() {
+    _current.clear();
+
+    {
+        // Held while summing: a thread exiting meanwhile waits to release its zones
+        std::lock_guard<std::mutex> lock(_threadsMutex);
+        for (const auto& thread : _threads) {
+            std::lock_guard<std::mutex> zonesLock(thread->mutex);
+            accumulate(thread->zones);
+            thread->zones.clear();
+        }
+        accumulate(_exitedZones);
+        _exitedZones.clear();
+    }
+
+    std::sort(_current.begin(), _current.end(), [](const PerfZoneStats& a, const PerfZoneStats& b) {
+        return a.total(PerfEvent::Cycles) > b.total(PerfEvent::Cycles);
+    });
+
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _lastFrame = _current;
+    return _current;
+}
+
+std::vector<PerfZoneStats> PerfCounters::getFrameStats() const {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _lastFrame;
+}
+
+void PerfCounters::reset() {
+    endFrame();
+    _current.clear();
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _lastFrame.clear();
+}
+
+size_t PerfCounters::getThreadCount() const {
+    std::lock_guard<std::mutex> lock(_threadsMutex);
+    return _threads.size();
+}
+
+PerfScope::PerfScope(const char* name, uint64_t items) : _name(name), _items(items) {
+    PerfCounters& counters = PerfCounters::getInstance();
+    if (!counters.isEnabled())
+        return;
+
+    _group = counters.threadGroup();
+    if (_group && !_group->read(_begin))
+        _group = nullptr;
+}
+
+PerfScope::~PerfScope() {
+    if (!_group)
+        return;
+
+    PerfReading end;
+    if (_group->read(end))
+        PerfCounters::getInstance().record(_name, _begin, end, _items);
+}
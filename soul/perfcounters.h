@@ -0,0 +1,197 @@
+#pragma once
+
+#include "singleton.h"
+#include "profiler.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace soul {
+
+enum class PerfEvent : uint8_t {
+    Cycles,
+    Instructions,
+    L1DMisses,      // L1 data cache read misses
+    LLCMisses,      // Last level cache misses
+    BranchMisses
+};
+
+inline constexpr size_t PERF_EVENT_COUNT = 5;
+
+/**
+ * @brief Values of the counters at one point, with the time the group was enabled
+ * and running so multiplexed counters can be scaled.
+ */
+struct PerfReading {
+    std::array<uint64_t, PERF_EVENT_COUNT> values {};
+    uint64_t enabled {0};
+    uint64_t running {0};
+};
+
+/**
+ * @brief Counters of a zone over the last frame.
+ * items is what the zone reports it processed (entities), so costs can be compared
+ * when the scene grows. Events the CPU does not support stay at 0 and are not in supported.
+ */
+struct PerfZoneStats {
+    const char* name {nullptr};
+    uint32_t calls {0};
+    uint64_t items {0};
+    uint32_t supported {0};    // Bit per PerfEvent
+    std::array<uint64_t, PERF_EVENT_COUNT> totals {};
+
+    bool has(PerfEvent event) const { return supported & (1u << static_cast<uint32_t>(event)); }
+    uint64_t total(PerfEvent event) const { return totals[static_cast<size_t>(event)]; }
+
+    // Instructions per cycle
+    double ipc() const {
+        const uint64_t cycles = total(PerfEvent::Cycles);
+        return cycles ? static_cast<double>(total(PerfEvent::Instructions)) / static_cast<double>(cycles) : 0.0;
+    }
+
+    double perItem(PerfEvent event) const {
+        return items ? static_cast<double>(total(event)) / static_cast<double>(items) : 0.0;
+    }
+};
+
+/**
+ * @brief Hardware counters of the calling thread, opened as one perf_event group
+ * (user space only) so they are scheduled together and read with a single read().
+ * Linux only: elsewhere, or when perf_event_open is refused, the group stays closed.
+ */
+class PerfCounterGroup {
+public:
+    PerfCounterGroup();
+    ~PerfCounterGroup();
+
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+
+    bool isOpen() const { return _leader >= 0; }
+    uint32_t supported() const { return _supported; }
+
+    // errno of the failed open, 0 when the group is open
+    int error() const { return _error; }
+
+    bool read(PerfReading& reading) const;
+
+private:
+    int _leader {-1};
+    int _error {0};
+    uint32_t _supported {0};
+    std::array<int, PERF_EVENT_COUNT> _fds {};
+    std::array<uint8_t, PERF_EVENT_COUNT> _slots {};   // Position in the group read
+};
+
+/**
+ * @brief Optional hardware counters backend of the profiler.
+ * Disabled by default. Once enabled, zones opened with SOUL_PROFILE_COUNTERS(name, items)
+ * read the counters of their thread at entry and exit and endFrame() sums them per zone.
+ * When perf events are not permitted (perf_event_paranoid, containers, other systems)
+ * the zones only keep their profiler timing and getStatus() tells why.
+ */
+class PerfCounters : public SingletonT<PerfCounters> {
+
+    MAKE_SINGLETON(PerfCounters)
+
+public:
+    void setEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // Whether the counters can be opened, probed once on the calling thread
+    bool isAvailable();
+    std::string getStatus();
+
+    // Counters of the calling thread, nullptr when they cannot be opened
+    PerfCounterGroup* threadGroup();
+
+    // Called by PerfScope when a zone closes
+    void record(const char* name, const PerfReading& begin, const PerfReading& end, uint64_t items);
+
+    // Sum the zones of every thread, returns the statistics of the frame that just ended
+    const std::vector<PerfZoneStats>& endFrame();
+
+    // Copy of the statistics of the last frame, safe from any thread
+    std::vector<PerfZoneStats> getFrameStats() const;
+
+    void reset();
+
+    // Threads with counters opened, a thread releases them when it exits
+    size_t getThreadCount() const;
+
+private:
+    struct ThreadZones {
+        PerfCounterGroup group;
+        std::mutex mutex;
+        std::vector<PerfZoneStats> zones;
+    };
+
+    // Thread local handle of the thread counters, unregisters them when the thread exits
+    struct ThreadOwner {
+        PerfCounters* counters {nullptr};
+        ThreadZones* zones {nullptr};
+        ~ThreadOwner();
+    };
+
+    ThreadZones* threadZones();
+
+    // Closes the counters of an exiting thread, its zones wait for the next endFrame
+    void unregisterThread(ThreadZones* zones);
+
+    // Adds the zones to the current frame
+    void accumulate(const std::vector<PerfZoneStats>& zones);
+
+private:
+    std::atomic<bool> _enabled {false};
+
+    std::once_flag _probeFlag;
+    bool _available {false};
+    std::string _status;
+
+    // Counters of the running threads, released when they exit
+    mutable std::mutex _threadsMutex;
+    std::vector<std::unique_ptr<ThreadZones>> _threads;
+    // Zones of the threads that exited since the last endFrame
+    std::vector<PerfZoneStats> _exitedZones;
+
+    // Only touched by the thread calling endFrame
+    std::vector<PerfZoneStats> _current;
+
+    mutable std::mutex _statsMutex;
+    std::vector<PerfZoneStats> _lastFrame;
+};
+
+/**
+ * @brief RAII counters zone, reads the thread group at construction and destruction.
+ * Costs a read() system call at each end, so it is kept to a few selected zones.
+ */
+class PerfScope {
+public:
+    explicit PerfScope(const char* name, uint64_t items = 1);
+    ~PerfScope();
+
+    PerfScope(const PerfScope&) = delete;
+    PerfScope& operator=(const PerfScope&) = delete;
+
+private:
+    const char* _name;
+    uint64_t _items;
+    PerfCounterGroup* _group {nullptr};
+    PerfReading _begin;
+};
+
+} // namespace soul
+
+// Profiler zone with hardware counters, items is the number of entities it processes
+#ifdef SOUL_DISABLE_PROFILER
+    #define SOUL_PROFILE_COUNTERS(name, items) ((void)0)
+#else
+    #define SOUL_PROFILE_COUNTERS(name, items) \
+        SOUL_PROFILE_SCOPE(name); \
+        soul::PerfScope SOUL_PROFILE_CONCAT(soulPerfScope_, __LINE__)(name, items)
+#endif
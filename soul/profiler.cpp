@@ -0,0 +1,182 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <format>
+#include <fstream>
+#include <stdexcept>
+
+using namespace soul;
+
+namespace {
+
+// Zone stack of the calling thread: parent and depth of the next zone
+thread_local const char* t_currentZone = nullptr;
+thread_local uint32_t t_depth = 0;
+thread_local ProfileEventBuffer* t_buffer = nullptr;
+
+void writeJsonString(std::ostream& out, const char* s) {
+    out << '"';
+    for (; s && *s; ++s) {
+        switch (*s) {
+            case '"':  out << "\\\""; break;
+            case '\\': out << "\\\\"; break;
+            case '\n': out << "\\n"; break;
+            default:
+                if (static_cast<unsigned char>(*s) < 0x20)
+                    out << std::format("\\u{:04x}", static_cast<unsigned>(*s));
+                else
+                    out << *s;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+ProfileScope::ProfileScope(const char* name) : _name(name) {
+    if (!Profiler::getInstance().isEnabled())
+        return;
+
+    _active = true;
+    _parent = t_currentZone;
+    _depth = t_depth++;
+    t_currentZone = name;
+    _elapsed.start();
+}
+
+ProfileScope::~ProfileScope() {
+    if (!_active)
+        return;
+
+    const std::chrono::nanoseconds duration = _elapsed.elapsed();
+    t_currentZone = _parent;
+    --t_depth;
+
+    Profiler& profiler = Profiler::getInstance();
+    profiler.record(_name, _parent, _depth, profiler.sinceEpoch(_elapsed.tpstart), duration.count());
+}
+
+ProfileEventBuffer& Profiler::threadBuffer() {
+    if (!t_buffer) {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        _buffers.push_back(std::make_unique<ProfileEventBuffer>(static_cast<uint32_t>(_buffers.size() + 1)));
+        t_buffer = _buffers.back().get();
+    }
+    return *t_buffer;
+}
+
+void Profiler::record(const char* name, const char* parent, uint32_t depth, int64_t start, int64_t duration) {
+    ProfileEventBuffer& buffer = threadBuffer();
+    buffer.push(ProfileEvent{name, parent, start, duration, depth, buffer.thread()});
+}
+
+void Profiler::aggregate(const ProfileEvent& event) {
+    // A frame has a few dozen zones at most: a linear scan on the addresses beats hashing
+    auto it = std::find_if(_current.begin(), _current.end(), [&event](const ProfileZoneStats& stats) {
+        return stats.name == event.name && stats.parent == event.parent;
+    });
+
+    const std::chrono::nanoseconds duration(event.duration);
+    if (it == _current.end()) {
+        _current.push_back(ProfileZoneStats{event.name, event.parent, event.depth, 1, duration, duration, duration});
+        return;
+    }
+
+    it->count++;
+    it->total += duration;
+    it->min = std::min(it->min, duration);
+    it->max = std::max(it->max, duration);
+}
+
+const std::vector<ProfileZoneStats>& Profiler::endFrame() {
+    _current.clear();
+
+    // Buffers are only added, the snapshot of the pointers is enough
+    std::vector<ProfileEventBuffer*> buffers;
+    {
+        std::lock_guard<std::mutex> lock(_buffersMutex);
+        buffers.reserve(_buffers.size());
+        for (const auto& buffer : _buffers)
+            buffers.push_back(buffer.get());
+    }
+
+    for (ProfileEventBuffer* buffer : buffers) {
+        buffer->drain([this](const ProfileEvent& event) {
+            aggregate(event);
+            if (_capturing && _capture.size() < MAX_CAPTURE_EVENTS)
+                _capture.push_back(event);
+        });
+    }
+
+    // Parents first, then by total time
+    std::sort(_current.begin(), _current.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b) {
+        return a.depth != b.depth ? a.depth < b.depth : a.total > b.total;
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(_statsMutex);
+        _lastFrame = _current;
+    }
+    _frameCount.fetch_add(1, std::memory_order_relaxed);
+    return _current;
+}
+
+std::vector<ProfileZoneStats> Profiler::getFrameStats() const {
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    return _lastFrame;
+}
+
+uint64_t Profiler::getDroppedEvents() const {
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    uint64_t dropped = 0;
+    for (const auto& buffer : _buffers)
+        dropped += buffer->dropped();
+    return dropped;
+}
+
+void Profiler::beginCapture() {
+    _capture.clear();
+    _capturing = true;
+}
+
+void Profiler::endCapture() {
+    _capturing = false;
+}
+
+size_t Profiler::getCaptureSize() const {
+    return _capture.size();
+}
+
+void Profiler::writeChromeTrace(std::ostream& out) const {
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    for (const ProfileEvent& event : _capture) {
+        out << (first ? "\n" : ",\n");
+        first = false;
+
+        out << "{\"name\":";
+        writeJsonString(out, event.name);
+        out << std::format(",\"cat\":\"soul\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+            static_cast<double>(event.start) / 1000.0, static_cast<double>(event.duration) / 1000.0, event.thread);
+    }
+    out << "\n]}\n";
+}
+
+void Profiler::writeChromeTrace(const std::string& fileName) const {
+    std::ofstream file(fileName);
+    if (!file.is_open()) {
+        throw std::runtime_error(std::format("Error: Cannot write the trace file {}.", fileName));
+    }
+    writeChromeTrace(file);
+}
+
+void Profiler::reset() {
+    // Events still in the buffers belong to the previous statistics
+    endFrame();
+    _current.clear();
+    _capture.clear();
+    _capturing = false;
+    std::lock_guard<std::mutex> lock(_statsMutex);
+    _lastFrame.clear();
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "singleton.h"
+#include "time_elapsed.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace soul {
+
+/**
+ * @brief One closed zone, as recorded by the thread that ran it.
+ * Names and parents are string literals (static storage), compared by address.
+ */
+struct ProfileEvent {
+    const char* name {nullptr};
+    const char* parent {nullptr};
+    int64_t     start {0};     // Nanoseconds since the profiler started
+    int64_t     duration {0};  // Nanoseconds
+    uint32_t    depth {0};
+    uint32_t    thread {0};
+};
+
+/**
+ * @brief Statistics of a zone over the last frame, per (parent, name) so the call tree is kept.
+ */
+struct ProfileZoneStats {
+    const char* name {nullptr};
+    const char* parent {nullptr};
+    uint32_t    depth {0};
+    uint32_t    count {0};
+    std::chrono::nanoseconds total {0};
+    std::chrono::nanoseconds min {0};
+    std::chrono::nanoseconds max {0};
+};
+
+/**
+ * @brief Single producer, single consumer ring of events.
+ * The owning thread pushes without locks, the profiler drains it at the end of the frame.
+ * When the ring is full the event is dropped and counted.
+ */
+class ProfileEventBuffer {
+public:
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    explicit ProfileEventBuffer(uint32_t thread) : _thread(thread) {}
+
+    bool push(const ProfileEvent& event) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head - _tail.load(std::memory_order_acquire) == CAPACITY) {
+            _dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        _events[head & (CAPACITY - 1)] = event;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side: calls f on every pending event
+    template<typename F>
+    size_t drain(F&& f) {
+        const size_t head = _head.load(std::memory_order_acquire);
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t count = head - tail;
+        for (; tail != head; ++tail)
+            f(_events[tail & (CAPACITY - 1)]);
+        _tail.store(tail, std::memory_order_release);
+        return count;
+    }
+
+    uint32_t thread() const { return _thread; }
+    uint64_t dropped() const { return _dropped.load(std::memory_order_relaxed); }
+
+private:
+    const uint32_t _thread;
+    alignas(64) std::atomic<size_t> _head {0};
+    alignas(64) std::atomic<size_t> _tail {0};
+    std::atomic<uint64_t> _dropped {0};
+    std::unique_ptr<ProfileEvent[]> _events {new ProfileEvent[CAPACITY]};
+};
+
+/**
+ * @brief Hierarchical zone profiler.
+ * Zones are opened with SOUL_PROFILE_SCOPE("name") and recorded per thread in lock-free buffers.
+ * endFrame(), called once per frame by the game loop, drains the buffers into the per-frame
+ * statistics (count, total, min, max) and, while a capture runs, into a Chrome trace_event
+ * capture that Perfetto or chrome://tracing can open.
+ */
+class Profiler : public SingletonT<Profiler> {
+
+    MAKE_SINGLETON(Profiler)
+
+public:
+    // Upper bound of the events kept by a capture
+    static constexpr size_t MAX_CAPTURE_EVENTS = 1 << 20;
+
+    void setEnabled(bool enabled) { _enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    // Called by ProfileScope when a zone closes
+    void record(const char* name, const char* parent, uint32_t depth, int64_t start, int64_t duration);
+
+    // Nanoseconds since the profiler started
+    int64_t sinceEpoch(TscClock::time_point tp) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(tp - _epoch).count();
+    }
+
+    // Drain the thread buffers, returns the statistics of the frame that just ended
+    const std::vector<ProfileZoneStats>& endFrame();
+
+    // Copy of the statistics of the last frame, safe from any thread
+    std::vector<ProfileZoneStats> getFrameStats() const;
+
+    uint64_t getFrameCount() const { return _frameCount.load(std::memory_order_relaxed); }
+    uint64_t getDroppedEvents() const;
+
+    // Record every event drained by endFrame until endCapture
+    void beginCapture();
+    void endCapture();
+    bool isCapturing() const { return _capturing; }
+    size_t getCaptureSize() const;
+
+    // Chrome trace_event JSON of the capture ("X" complete events, microseconds)
+    void writeChromeTrace(std::ostream& out) const;
+    void writeChromeTrace(const std::string& fileName) const;
+
+    // Forget the statistics and the capture
+    void reset();
+
+private:
+    ProfileEventBuffer& threadBuffer();
+
+    void aggregate(const ProfileEvent& event);
+
+private:
+    TscClock::time_point _epoch {TscClock::now()};
+    std::atomic<bool> _enabled {true};
+    std::atomic<uint64_t> _frameCount {0};
+
+    // Thread buffers, owned here so events survive the exit of their thread
+    mutable std::mutex _buffersMutex;
+    std::vector<std::unique_ptr<ProfileEventBuffer>> _buffers;
+
+    // Only touched by the thread calling endFrame
+    std::vector<ProfileZoneStats> _current;
+    bool _capturing {false};
+    std::vector<ProfileEvent> _capture;
+
+    mutable std::mutex _statsMutex;
+    std::vector<ProfileZoneStats> _lastFrame;
+};
+
+/**
+ * @brief RAII zone: measures from construction to destruction with st_time_elapsed
+ * on TscClock, nested zones know their parent through a per-thread stack.
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name);
+    ~ProfileScope();
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* _name;
+    const char* _parent {nullptr};
+    uint32_t _depth {0};
+    bool _active {false};
+    st_time_elapsed<TscClock> _elapsed;
+};
+
+} // namespace soul
+
+#define SOUL_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SOUL_PROFILE_CONCAT(a, b) SOUL_PROFILE_CONCAT_IMPL(a, b)
+
+// g++ -DSOUL_DISABLE_PROFILER removes every zone at compile time
+#ifdef SOUL_DISABLE_PROFILER
+    #define SOUL_PROFILE_SCOPE(name) ((void)0)
+#else
+    #define SOUL_PROFILE_SCOPE(name) soul::ProfileScope SOUL_PROFILE_CONCAT(soulProfileScope_, __LINE__)(name)
+#endif
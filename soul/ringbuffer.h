@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace soul {
+
+/**
+ * @brief Fixed-capacity ring: push overwrites the oldest value once full, never allocates.
+ * Index 0 is the oldest value. data() and offset() give the raw storage and the position
+ * of the oldest value, the layout expected by ImGui::PlotLines.
+ */
+template<typename T, size_t N>
+class RingBuffer {
+    static_assert(N > 0, "RingBuffer needs a capacity");
+
+public:
+    void push(const T& value) {
+        _data[_next] = value;
+        _next = _next + 1 == N ? 0 : _next + 1;
+        if (_size < N)
+            ++_size;
+    }
+
+    const T& operator[](size_t i) const { return _data[(offset() + i) % N]; }
+
+    // Most recent value, the ring must not be empty
+    const T& back() const { return _data[_next == 0 ? N - 1 : _next - 1]; }
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+    static constexpr size_t capacity() { return N; }
+
+    const T* data() const { return _data.data(); }
+    size_t offset() const { return _size < N ? 0 : _next; }
+
+    void clear() {
+        _next = 0;
+        _size = 0;
+    }
+
+private:
+    std::array<T, N> _data {};
+    size_t _next {0};
+    size_t _size {0};
+};
+
+} // namespace soul
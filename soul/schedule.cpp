@@ -0,0 +1,84 @@
+#include "schedule.h"
+
+using namespace soul;
+
+namespace {
+
+// Weekends only, for schedules without holiday calendar
+const HolidayCalendar* weekends() {
+    static const HolidayCalendar calendar;
+    return &calendar;
+}
+
+} // namespace
+
+Schedule::Schedule(Date start, Date end, Frequency frequency,
+    RollConvention convention, const HolidayCalendar* holidays, bool endOfMonth)
+    : _start(start), _convention(convention), _holidays(holidays ? holidays : weekends()) {
+
+    switch (frequency) {
+    case Frequency::Daily:      _stepDays = 1; break;
+    case Frequency::Weekly:     _stepDays = 7; break;
+    case Frequency::Monthly:    _stepMonths = 1; break;
+    case Frequency::Quarterly:  _stepMonths = 3; break;
+    case Frequency::SemiAnnual: _stepMonths = 6; break;
+    case Frequency::Annual:     _stepMonths = 12; break;
+    }
+
+    _endOfMonth = endOfMonth && _stepMonths > 0 && start == start.endOfMonth();
+
+    if (end < start)
+        return;
+
+    if (_stepDays > 0) {
+        _size = static_cast<size_t>((end - start) / _stepDays) + 1;
+        return;
+    }
+
+    // Whole periods between the months, minus the last one when it ends past the end date
+    const calendar::CivilDate first = start.civil();
+    const calendar::CivilDate last = end.civil();
+    const int32_t months = (last.year - first.year) * 12 + static_cast<int32_t>(last.month) - static_cast<int32_t>(first.month);
+    _size = static_cast<size_t>(months / _stepMonths) + 1;
+    if (unadjusted(_size - 1) > end)
+        --_size;
+}
+
+Date Schedule::unadjusted(size_t i) const {
+    const int32_t n = static_cast<int32_t>(i);
+    if (_stepDays > 0)
+        return _start + n * _stepDays;
+
+    const Date date = _start.addMonths(n * _stepMonths);
+    return _endOfMonth ? date.endOfMonth() : date;
+}
+
+size_t Schedule::generate(std::span<Date> out) const {
+    const size_t count = out.size() < _size ? out.size() : _size;
+    Date* data = out.data();
+
+    if (_stepDays > 0) {
+        for (size_t i = 0; i < count; ++i)
+            data[i] = _start + static_cast<int32_t>(i) * _stepDays;
+    } else {
+        // Walk the months once instead of converting the start date for every entry
+        const calendar::CivilDate first = _start.civil();
+        int32_t year = first.year;
+        int32_t month = static_cast<int32_t>(first.month);
+        for (size_t i = 0; i < count; ++i) {
+            const uint32_t last = calendar::lastDayOfMonth(year, static_cast<uint32_t>(month));
+            const uint32_t day = _endOfMonth || first.day > last ? last : first.day;
+            data[i] = Date(year, static_cast<uint32_t>(month), day);
+
+            month += _stepMonths;
+            year += (month - 1) / 12;
+            month = (month - 1) % 12 + 1;
+        }
+    }
+
+    if (_convention != RollConvention::Unadjusted) {
+        for (size_t i = 0; i < count; ++i)
+            data[i] = Date(_holidays->adjust(data[i].days, _convention));
+    }
+    return count;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+
+#include "date.h"
+#include "holidaycalendar.h"
+
+namespace soul {
+
+enum class Frequency : uint8_t {
+    Daily,
+    Weekly,
+    Monthly,
+    Quarterly,
+    SemiAnnual,
+    Annual
+};
+
+/**
+ * @brief Recurring series of dates from start to end (included when on the series).
+ * Every date is computed from the start, start + i * period, with the pure calendar
+ * arithmetic, so a month-end clamp never drifts (Jan 31, Feb 28, Mar 31, ...).
+ * With the end-of-month rule a start on the last day of a month gives month ends only.
+ * Dates are then moved to business days with the roll convention and the holiday calendar,
+ * which must outlive the schedule (weekends only when none is given).
+ * The series is lazy: iterate it, index it, or generate it into a preallocated buffer.
+ */
+class Schedule {
+public:
+    Schedule(Date start, Date end, Frequency frequency,
+        RollConvention convention = RollConvention::Unadjusted, const HolidayCalendar* holidays = nullptr, bool endOfMonth = false);
+
+    // Number of dates, computed without generating them
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    // Date i before the roll convention
+    Date unadjusted(size_t i) const;
+
+    // Date i after the roll convention
+    Date operator[](size_t i) const {
+        return Date(_holidays->adjust(unadjusted(i).days, _convention));
+    }
+
+    // Writes the first min(size(), out.size()) dates in one pass, returns how many were written
+    size_t generate(std::span<Date> out) const;
+
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Date;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Date*;
+        using reference = Date;
+
+        Iterator() = default;
+        Iterator(const Schedule* schedule, size_t index) : _schedule(schedule), _index(index) {}
+
+        Date operator*() const { return (*_schedule)[_index]; }
+        Iterator& operator++() { ++_index; return *this; }
+        Iterator operator++(int) { Iterator it = *this; ++_index; return it; }
+        bool operator==(const Iterator& other) const { return _index == other._index; }
+
+    private:
+        const Schedule* _schedule {nullptr};
+        size_t _index {0};
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, _size); }
+
+private:
+    Date _start;
+    int32_t _stepDays {0};    // Daily and weekly series
+    int32_t _stepMonths {0};  // Monthly to annual series
+    bool _endOfMonth {false};
+    RollConvention _convention;
+    const HolidayCalendar* _holidays;
+    size_t _size {0};
+};
+
+} // namespace soul
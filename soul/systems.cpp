@@ -0,0 +1,55 @@
+#include "systems.h"
+#include "profiler.h"
+
+using namespace soul::ecs;
+
+void soul::ecs::integrate(World& world, float dt) {
+    SOUL_PROFILE_SCOPE("ecs::integrate");
+
+    world.forEachChunk<Transform, Velocity>([dt](size_t count, const EntityId*, Transform* transforms, Velocity* velocities) {
+        for (size_t i = 0; i < count; ++i) {
+            transforms[i].x += velocities[i].dx * dt;
+            transforms[i].y += velocities[i].dy * dt;
+        }
+    });
+}
+
+void soul::ecs::animate(World& world, float dt) {
+    SOUL_PROFILE_SCOPE("ecs::animate");
+
+    world.forEachChunk<Animation, Sprite>([dt](size_t count, const EntityId*, Animation* animations, Sprite* sprites) {
+        for (size_t i = 0; i < count; ++i) {
+            Animation& animation = animations[i];
+            animation.elapsed += dt;
+            if (animation.elapsed < animation.frameTime)
+                continue;
+
+            // Frames skipped by a long frame are all applied, without a loop
+            const uint32_t steps = static_cast<uint32_t>(animation.elapsed / animation.frameTime);
+            animation.elapsed -= static_cast<float>(steps) * animation.frameTime;
+            animation.frame = static_cast<uint16_t>((animation.frame + steps) % animation.frameCount);
+            sprites[i].u = animation.originU + static_cast<float>(animation.frame) * sprites[i].width;
+        }
+    });
+}
+
+void soul::ecs::expire(World& world, float dt) {
+    SOUL_PROFILE_SCOPE("ecs::expire");
+
+    world.forEachChunk<Lifetime>([&world, dt](size_t count, const EntityId* ids, Lifetime* lifetimes) {
+        for (size_t i = 0; i < count; ++i) {
+            lifetimes[i].remaining -= dt;
+            if (lifetimes[i].remaining <= 0.0f)
+                world.destroyLater(ids[i]);
+        }
+    });
+}
+
+void soul::ecs::update(World& world, float dt) {
+    SOUL_PROFILE_SCOPE("ecs::update");
+
+    integrate(world, dt);
+    animate(world, dt);
+    expire(world, dt);
+    world.flush();
+}
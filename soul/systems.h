@@ -0,0 +1,19 @@
+#pragma once
+
+#include "world.h"
+
+namespace soul::ecs {
+
+// Transform += Velocity * dt
+void integrate(World& world, float dt);
+
+// Advances the animations and moves the sprite rect to their current frame
+void animate(World& world, float dt);
+
+// Counts down the lifetimes, the entities whose time is over are destroyed by the next flush
+void expire(World& world, float dt);
+
+// Runs the systems in order, then destroys the expired entities
+void update(World& world, float dt);
+
+} // namespace soul::ecs
@@ -0,0 +1,38 @@
+#include "taginterner.h"
+
+#include <format>
+#include <stdexcept>
+
+using namespace soul;
+
+TagId TagInterner::intern(std::string_view tag) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _ids.find(tag);
+    if (it != _ids.end())
+        return it->second;
+
+    const TagId id = static_cast<TagId>(_names.size());
+    _names.emplace_back(tag);
+    _ids.emplace(_names.back(), id);
+    return id;
+}
+
+std::optional<TagId> TagInterner::find(std::string_view tag) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _ids.find(tag);
+    if (it == _ids.end())
+        return std::nullopt;
+    return it->second;
+}
+
+const std::string& TagInterner::name(TagId id) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (id >= _names.size())
+        throw std::out_of_range(std::format("Error: Unknown tag id {}.", id));
+    return _names[id];
+}
+
+size_t TagInterner::size() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _names.size();
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "singleton.h"
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace soul {
+
+// Dense id of an interned tag, the first tag is 0
+using TagId = uint32_t;
+
+/**
+ * @brief Global tag interner.
+ * Maps every tag string to a dense TagId the first time it is seen, so containers
+ * index flat arrays by TagId instead of comparing strings. The name of a tag has a
+ * stable address for the life of the program. Thread safe.
+ */
+class TagInterner : public SingletonT<TagInterner> {
+
+    MAKE_SINGLETON(TagInterner)
+
+public:
+    // Id of the tag, created when it is new
+    TagId intern(std::string_view tag);
+
+    // Id of the tag when it was already interned
+    std::optional<TagId> find(std::string_view tag) const;
+
+    // Name of the tag, the reference stays valid
+    const std::string& name(TagId id) const;
+
+    size_t size() const;
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>()(s); }
+    };
+
+    mutable std::mutex _mutex;
+    std::unordered_map<std::string, TagId, StringHash, std::equal_to<>> _ids;
+    // A deque never moves its elements when it grows
+    std::deque<std::string> _names;
+};
+
+} // namespace soul
@@ -1,22 +1,164 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <format>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #include <x86intrin.h>
+    #include <cpuid.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+    #include <intrin.h>
+#endif
 
 using namespace std::literals; // enables literal suffixes, e.g. 24h, 1ms, 1s.
 
 namespace soul {
 
+/**
+ * @brief Clock reading the CPU time stamp counter (rdtsc on x86, cntvct_el0 on aarch64),
+ * a few nanoseconds per call instead of the 20-40 ns of steady_clock through the vDSO.
+ * Ticks are converted to nanoseconds with a fixed-point factor calibrated once against
+ * steady_clock (read from cntfrq_el0 on aarch64). Without an invariant counter (constant
+ * rate across frequency changes and sleep states) now() falls back to steady_clock.
+ * Satisfies the chrono Clock requirements, its epoch is the calibration.
+ */
+struct TscClock {
+    using rep = int64_t;
+    using period = std::nano;
+    using duration = std::chrono::nanoseconds;
+    using time_point = std::chrono::time_point<TscClock, duration>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept {
+        const Calibration& c = calibration();
+        if (!c.invariant) {
+            return time_point(std::chrono::duration_cast<duration>(std::chrono::steady_clock::now() - c.steadyBase));
+        }
+        return time_point(duration(toNanoseconds(static_cast<int64_t>(readCounter() - c.counterBase), c)));
+    }
+
+    // True when now() reads the counter, false when it falls back to steady_clock
+    static bool isInvariant() noexcept { return calibration().invariant; }
+
+    // Counter ticks per second, 0 on fallback
+    static double frequency() noexcept {
+        const Calibration& c = calibration();
+        return c.invariant ? 1e9 * 4294967296.0 / static_cast<double>(c.nsPerTick32) : 0.0;
+    }
+
+    // Raw counter value, no ordering with the surrounding instructions
+    static uint64_t readCounter() noexcept {
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+        return __rdtsc();
+#elif defined(__aarch64__)
+        uint64_t value;
+        asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+        return value;
+#else
+        return 0;
+#endif
+    }
+
+    static bool hasInvariantCounter() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+        // CPUID.80000007H:EDX[8] is the invariant TSC flag
+        unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007)
+            return false;
+        __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+        return (edx & (1u << 8)) != 0;
+#elif defined(_M_X64) || defined(_M_IX86)
+        int info[4] = {};
+        __cpuid(info, 0x80000000);
+        if (static_cast<unsigned int>(info[0]) < 0x80000007)
+            return false;
+        __cpuid(info, 0x80000007);
+        return (info[3] & (1 << 8)) != 0;
+#elif defined(__aarch64__)
+        // The generic timer counts at a constant frequency
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    struct Calibration {
+        bool     invariant {false};
+        uint64_t counterBase {0};
+        uint64_t nsPerTick32 {0};  // Nanoseconds per tick, 32.32 fixed point
+        std::chrono::steady_clock::time_point steadyBase {};
+    };
+
+    // Signed: a core may read a counter slightly behind the base
+    static int64_t toNanoseconds(int64_t ticks, const Calibration& c) noexcept {
+#if defined(__SIZEOF_INT128__)
+        // __extension__ keeps -pedantic quiet about the non-standard type
+        __extension__ typedef __int128 int128_t;
+        return static_cast<int64_t>((static_cast<int128_t>(ticks) * static_cast<int128_t>(c.nsPerTick32)) >> 32);
+#else
+        return static_cast<int64_t>(static_cast<double>(ticks) * static_cast<double>(c.nsPerTick32) / 4294967296.0);
+#endif
+    }
+
+    static Calibration calibrate() {
+        Calibration c;
+        c.steadyBase = std::chrono::steady_clock::now();
+        if (!hasInvariantCounter())
+            return c;
+
+#if defined(__aarch64__)
+        uint64_t frequency;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+        c.counterBase = readCounter();
+        c.nsPerTick32 = static_cast<uint64_t>(1e9 * 4294967296.0 / static_cast<double>(frequency));
+#else
+        // Ticks counted over 20 ms of steady_clock
+        const uint64_t counter0 = readCounter();
+        const auto steady0 = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const uint64_t counter1 = readCounter();
+        const auto steady1 = std::chrono::steady_clock::now();
+
+        const double ns = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(steady1 - steady0).count());
+        const double ticks = static_cast<double>(counter1 - counter0);
+        if (ticks <= 0.0)
+            return c;
+        c.counterBase = counter0;
+        c.steadyBase = steady0;
+        c.nsPerTick32 = static_cast<uint64_t>(ns / ticks * 4294967296.0);
+#endif
+        c.invariant = c.nsPerTick32 != 0;
+        return c;
+    }
+
+    static const Calibration& calibration() noexcept {
+        static const Calibration s_calibration = calibrate();
+        return s_calibration;
+    }
+};
+
+/**
+ * @brief Elapsed time since start(), on steady_clock by default or on any chrono clock
+ * (TscClock for the cheap reads of the profiler zones).
+ */
+template<typename Clock = std::chrono::steady_clock>
 struct st_time_elapsed {
-    std::chrono::time_point<std::chrono::steady_clock>      tpstart;
+    typename Clock::time_point      tpstart;
 
     void start() {
-        tpstart = std::chrono::steady_clock::now();
+        tpstart = Clock::now();
+    }
+
+    std::chrono::nanoseconds elapsed() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - tpstart);
     }
 
     void print_elapsed_ms() {
-        const auto end = std::chrono::steady_clock::now();
+        const auto end = Clock::now();
         auto value = std::chrono::duration_cast<std::chrono::microseconds>(end - tpstart);
 
         std::cout << "Calculations took " 
@@ -26,7 +168,7 @@ struct st_time_elapsed {
     }
 
     void print_elapsed_ns() {
-        const auto end = std::chrono::steady_clock::now();
+        const auto end = Clock::now();
         auto value = std::chrono::duration_cast<std::chrono::nanoseconds>(end - tpstart);
 
         std::cout << "time elapsed: " << value 
@@ -35,7 +177,7 @@ struct st_time_elapsed {
     }
 
     void print_elapsed_s() {
-        const auto end = std::chrono::steady_clock::now();
+        const auto end = Clock::now();
         const std::chrono::duration<double> elapsed_seconds(end - tpstart);
 
         std::cout << "Elapsed time: ";
@@ -0,0 +1,146 @@
+#include "world.h"
+
+#include <cstring>
+
+using namespace soul::ecs;
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+Archetype::Archetype(ComponentMask mask) : _mask(mask) {
+    size_t rowBytes = sizeof(EntityId);
+    size_t arrays = 1;
+    for (uint32_t c = 0; c < COMPONENT_COUNT; ++c) {
+        if (has(c)) {
+            rowBytes += COMPONENT_SIZES[c];
+            ++arrays;
+        }
+    }
+
+    // Worst case padding of every array to its alignment
+    _capacity = (CHUNK_BYTES - arrays * ARRAY_ALIGNMENT) / rowBytes;
+
+    size_t offset = alignUp(_capacity * sizeof(EntityId), ARRAY_ALIGNMENT);
+    for (uint32_t c = 0; c < COMPONENT_COUNT; ++c) {
+        if (has(c)) {
+            _offsets[c] = offset;
+            offset = alignUp(offset + _capacity * COMPONENT_SIZES[c], ARRAY_ALIGNMENT);
+        }
+    }
+}
+
+size_t Archetype::push(EntityId id) {
+    if (_size == _chunks.size() * _capacity) {
+        std::byte* chunk = static_cast<std::byte*>(::operator new[](CHUNK_BYTES, std::align_val_t(ARRAY_ALIGNMENT)));
+        _chunks.emplace_back(chunk);
+    }
+
+    const size_t row = _size++;
+    entity(row) = id;
+    return row;
+}
+
+EntityId Archetype::swapRemove(size_t row) {
+    const size_t last = --_size;
+    if (row == last)
+        return EntityId {};
+
+    for (uint32_t c = 0; c < COMPONENT_COUNT; ++c) {
+        if (has(c))
+            std::memcpy(component(row, c), component(last, c), COMPONENT_SIZES[c]);
+    }
+    entity(row) = entity(last);
+    return entity(row);
+}
+
+World::World() {
+    _archetypeOfMask.fill(NO_ARCHETYPE);
+}
+
+uint32_t World::archetypeOf(ComponentMask mask) {
+    uint32_t& index = _archetypeOfMask[mask];
+    if (index == NO_ARCHETYPE) {
+        index = static_cast<uint32_t>(_archetypes.size());
+        _archetypes.push_back(std::make_unique<Archetype>(mask));
+    }
+    return index;
+}
+
+EntityId World::allocate() {
+    ++_size;
+    if (!_freeSlots.empty()) {
+        const uint32_t index = _freeSlots.back();
+        _freeSlots.pop_back();
+        return EntityId {index, _records[index].generation};
+    }
+    _records.emplace_back();
+    return EntityId {static_cast<uint32_t>(_records.size() - 1), 0};
+}
+
+void World::place(EntityId id, uint32_t archetype, size_t row) {
+    Record& record = _records[id.index];
+    record.archetype = archetype;
+    record.row = static_cast<uint32_t>(row);
+}
+
+void World::erase(const Record& record) {
+    const EntityId moved = _archetypes[record.archetype]->swapRemove(record.row);
+    if (moved.isValid())
+        _records[moved.index].row = record.row;
+}
+
+void World::destroy(EntityId id) {
+    if (!isAlive(id))
+        return;
+
+    Record& record = _records[id.index];
+    erase(record);
+    record.archetype = NO_ARCHETYPE;
+    // Handles of the previous generation are now stale
+    record.generation++;
+    _freeSlots.push_back(id.index);
+    --_size;
+}
+
+void World::flush() {
+    // Destroying twice is harmless, the second handle is stale
+    for (const EntityId id : _pending)
+        destroy(id);
+    _pending.clear();
+}
+
+size_t World::move(EntityId id, ComponentMask mask) {
+    const Record from = _records[id.index];
+    const uint32_t index = archetypeOf(mask);
+    Archetype& source = *_archetypes[from.archetype];
+    Archetype& target = *_archetypes[index];
+
+    const size_t row = target.push(id);
+    for (uint32_t c = 0; c < COMPONENT_COUNT; ++c) {
+        if (source.has(c) && target.has(c))
+            std::memcpy(target.component(row, c), source.component(from.row, c), COMPONENT_SIZES[c]);
+    }
+
+    erase(from);
+    place(id, index, row);
+    return row;
+}
+
+void World::clear() {
+    for (auto& archetype : _archetypes)
+        archetype->clear();
+    for (uint32_t i = 0; i < _records.size(); ++i) {
+        if (_records[i].archetype != NO_ARCHETYPE) {
+            _records[i].archetype = NO_ARCHETYPE;
+            _records[i].generation++;
+            _freeSlots.push_back(i);
+        }
+    }
+    _pending.clear();
+    _size = 0;
+}
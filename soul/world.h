@@ -0,0 +1,245 @@
+#pragma once
+
+#include "components.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <vector>
+
+namespace soul::ecs {
+
+/**
+ * @brief Handle of an entity of the World: the slot index and the generation of the slot,
+ * so a handle kept after destroy() is detected instead of reaching the entity reusing the slot.
+ */
+struct EntityId {
+    static constexpr uint32_t INVALID = ~0u;
+
+    uint32_t index {INVALID};
+    uint32_t generation {0};
+
+    bool isValid() const { return index != INVALID; }
+    bool operator==(const EntityId&) const = default;
+};
+
+/**
+ * @brief Entities sharing the same set of components.
+ * Rows are stored in fixed-size chunks of CHUNK_BYTES: in each chunk every component,
+ * and the entity ids, is one contiguous array (struct of arrays), so a system only
+ * touches the arrays it needs. Every chunk is full but the last one, removal moves
+ * the last row into the hole to keep the rows dense. Chunks are kept for reuse.
+ */
+class Archetype {
+public:
+    static constexpr size_t CHUNK_BYTES = 16 * 1024;
+    static constexpr size_t ARRAY_ALIGNMENT = 64;
+
+    explicit Archetype(ComponentMask mask);
+
+    ComponentMask mask() const { return _mask; }
+    bool has(uint32_t component) const { return _mask & (ComponentMask(1) << component); }
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _capacity; }
+
+    size_t chunkCount() const { return (_size + _capacity - 1) / _capacity; }
+    size_t chunkSize(size_t chunk) const {
+        const size_t begin = chunk * _capacity;
+        return _size - begin < _capacity ? _size - begin : _capacity;
+    }
+
+    // Arrays of a chunk
+    template<typename T>
+    T* column(size_t chunk) const {
+        return reinterpret_cast<T*>(_chunks[chunk].get() + _offsets[componentId<T>()]);
+    }
+    EntityId* entities(size_t chunk) const {
+        return reinterpret_cast<EntityId*>(_chunks[chunk].get());
+    }
+
+    // Component of a row, the archetype must have it
+    void* component(size_t row, uint32_t component) const {
+        return _chunks[row / _capacity].get() + _offsets[component] + (row % _capacity) * COMPONENT_SIZES[component];
+    }
+    template<typename T>
+    T& get(size_t row) const { return *static_cast<T*>(component(row, componentId<T>())); }
+
+    EntityId& entity(size_t row) const { return entities(row / _capacity)[row % _capacity]; }
+
+    // Appends a row with uninitialized components, returns it
+    size_t push(EntityId id);
+
+    // Moves the last row into row, returns the entity moved there (invalid when row was the last)
+    EntityId swapRemove(size_t row);
+
+    void clear() { _size = 0; }
+
+private:
+    struct AlignedDelete {
+        void operator()(std::byte* p) const { ::operator delete[](p, std::align_val_t(ARRAY_ALIGNMENT)); }
+    };
+
+    ComponentMask _mask;
+    size_t _capacity {0};
+    size_t _size {0};
+    std::array<size_t, COMPONENT_COUNT> _offsets {};
+    std::vector<std::unique_ptr<std::byte[], AlignedDelete>> _chunks;
+};
+
+/**
+ * @brief Archetype ECS storage.
+ * Entities are rows of the archetype of their component set, systems iterate the
+ * matching archetypes chunk by chunk over dense arrays, without virtual calls or pointer chasing.
+ * Adding or removing a component moves the entity to another archetype.
+ * An entity must not be created or destroyed while its archetypes are iterated:
+ * destroyLater() queues it and flush() applies the queue once the systems are done.
+ * Not synchronized.
+ */
+class World {
+public:
+    World();
+
+    template<typename... Cs>
+    EntityId create(const Cs&... components) {
+        static_assert(sizeof...(Cs) > 0, "An entity needs at least one component");
+        static_assert(std::popcount(maskOf<Cs...>()) == sizeof...(Cs), "Duplicate component");
+
+        const uint32_t index = archetypeOf(maskOf<Cs...>());
+        Archetype& archetype = *_archetypes[index];
+        const EntityId id = allocate();
+        const size_t row = archetype.push(id);
+        ((archetype.get<Cs>(row) = components), ...);
+        place(id, index, row);
+        return id;
+    }
+
+    // Destroys the entity, stale handles are ignored
+    void destroy(EntityId id);
+
+    // Deferred destroy, safe while iterating
+    void destroyLater(EntityId id) { _pending.push_back(id); }
+    void flush();
+
+    bool isAlive(EntityId id) const {
+        return id.index < _records.size() && _records[id.index].generation == id.generation
+            && _records[id.index].archetype != NO_ARCHETYPE;
+    }
+
+    template<typename T>
+    bool has(EntityId id) const {
+        return isAlive(id) && _archetypes[_records[id.index].archetype]->has(componentId<T>());
+    }
+
+    // Component of the entity, nullptr when it is dead or does not have it
+    template<typename T>
+    T* get(EntityId id) const {
+        if (!has<T>(id))
+            return nullptr;
+        const Record& record = _records[id.index];
+        return &_archetypes[record.archetype]->get<T>(record.row);
+    }
+
+    // Adds or replaces a component
+    template<typename T>
+    void add(EntityId id, const T& component) {
+        if (!isAlive(id))
+            return;
+        if (T* existing = get<T>(id)) {
+            *existing = component;
+            return;
+        }
+        const Record& record = _records[id.index];
+        const size_t row = move(id, _archetypes[record.archetype]->mask() | maskOf<T>());
+        _archetypes[_records[id.index].archetype]->get<T>(row) = component;
+    }
+
+    template<typename T>
+    void remove(EntityId id) {
+        if (!has<T>(id))
+            return;
+        const ComponentMask mask = _archetypes[_records[id.index].archetype]->mask() & ~maskOf<T>();
+        if (mask == 0)
+            destroy(id);
+        else
+            move(id, mask);
+    }
+
+    /**
+     * @brief Calls f(count, ids, arrays...) for every chunk of the archetypes having the components Cs,
+     * with one array of count components per type. Systems loop over the arrays.
+     */
+    template<typename... Cs, typename F>
+    void forEachChunk(F&& f) const {
+        constexpr ComponentMask required = maskOf<Cs...>();
+        for (const auto& archetype : _archetypes) {
+            if ((archetype->mask() & required) != required)
+                continue;
+            const size_t chunks = archetype->chunkCount();
+            for (size_t chunk = 0; chunk < chunks; ++chunk)
+                f(archetype->chunkSize(chunk), archetype->entities(chunk), archetype->column<Cs>(chunk)...);
+        }
+    }
+
+    // Calls f(components...) for every entity having the components Cs
+    template<typename... Cs, typename F>
+    void each(F&& f) const {
+        forEachChunk<Cs...>([&f](size_t count, const EntityId*, Cs*... arrays) {
+            for (size_t i = 0; i < count; ++i)
+                f(arrays[i]...);
+        });
+    }
+
+    // Number of entities having the components Cs
+    template<typename... Cs>
+    size_t count() const {
+        constexpr ComponentMask required = maskOf<Cs...>();
+        size_t total = 0;
+        for (const auto& archetype : _archetypes) {
+            if ((archetype->mask() & required) == required)
+                total += archetype->size();
+        }
+        return total;
+    }
+
+    size_t size() const { return _size; }
+    size_t getCountArchetypes() const { return _archetypes.size(); }
+
+    void clear();
+
+private:
+    static constexpr uint32_t NO_ARCHETYPE = ~0u;
+
+    struct Record {
+        uint32_t archetype {NO_ARCHETYPE};
+        uint32_t row {0};
+        uint32_t generation {0};
+    };
+
+    // Index of the archetype of mask, created on first use
+    uint32_t archetypeOf(ComponentMask mask);
+
+    EntityId allocate();
+    void place(EntityId id, uint32_t archetype, size_t row);
+
+    // Removes the row of the entity from its archetype, fixing the entity moved into it
+    void erase(const Record& record);
+
+    // Moves the entity to the archetype of mask with the components both have, returns its new row
+    size_t move(EntityId id, ComponentMask mask);
+
+private:
+    // Archetypes are created on demand and never removed, so the index of a mask is stable
+    std::vector<std::unique_ptr<Archetype>> _archetypes;
+    std::array<uint32_t, size_t(1) << COMPONENT_COUNT> _archetypeOfMask;
+
+    std::vector<Record> _records;
+    std::vector<uint32_t> _freeSlots;
+    std::vector<EntityId> _pending;
+    size_t _size {0};
+};
+
+} // namespace soul::ecs
@@ -12,6 +12,7 @@ using namespace soul;
 Animable::Animable(const std::string& name) : Entity(name) {
     _sprite = std::make_shared<Sprite2d>(this->tag());
     _animations = std::make_shared<AnimationSet>(_sprite);
+    setFlags(ENTITY_RENDERABLE);
 }
 
 void Animable::load(const sSpriteData& spriteData, const sTransformScalars& scalars) {
@@ -125,5 +126,5 @@ void Animable::render() {
 
     // std::cout << "Render " << this->ID() << std::endl;
 
-    gw.window.draw(_sprite->getSprite());
+    gw.draw(_sprite->getSprite());
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 
 using namespace soul;
 
+// Log channel of the assets
+static const LogCategory s_logAssets = LoggerManager::getInstance().registerCategory("Assets");
+
 std::shared_ptr<Texture2d>& AssetManager::getTexture(const std::string& name) {
     std::map<std::string, std::shared_ptr<Texture2d>>::iterator it = mapTextures.find(name);
     if (it == mapTextures.end())
@@ -15,15 +18,15 @@ std::shared_ptr<Texture2d>& AssetManager::addTexture(const std::string& name, co
     // Texture exists
     auto& logManager = LoggerManager::getInstance();
 
-    logManager.log("AddTexture {}", name);
+    logManager.log(s_logAssets, LOG_LEVEL::LOG_DEBUG, "AddTexture {}", name);
 
     if (textureKeys.search(name)) {
-        logManager.log("Texture with name {} was found", name);
+        logManager.log(s_logAssets, LOG_LEVEL::LOG_DEBUG, "Texture with name {} was found", name);
         return getTexture(name);
     }
 
     // Create texture in manager
-    logManager.log("Create New Texture with name {}", name);
+    logManager.log(s_logAssets, LOG_LEVEL::LOG_INFO, "Create New Texture with name {}", name);
     auto newTexture = std::make_shared<Texture2d>(name, file_path, is_smooth);
 
     auto resp = newTexture->loadTexture(file_path);
@@ -39,15 +42,15 @@ std::shared_ptr<Texture2d>& AssetManager::addTextureImageFilter(const std::strin
     // Texture exists
     auto& logManager = LoggerManager::getInstance();
 
-    logManager.log("AddTexture {}", name);
+    logManager.log(s_logAssets, LOG_LEVEL::LOG_DEBUG, "AddTexture {}", name);
 
     if (textureKeys.search(name)) {
-        logManager.log("Texture with name {} was found", name);
+        logManager.log(s_logAssets, LOG_LEVEL::LOG_DEBUG, "Texture with name {} was found", name);
         return getTexture(name);
     }
 
     // Create texture in manager
-    logManager.log("Create New Texture from Image with name {}", name);
+    logManager.log(s_logAssets, LOG_LEVEL::LOG_INFO, "Create New Texture from Image with name {}", name);
     auto newTexture = std::make_shared<Texture2d>(name, file_path, is_smooth);
 
     auto resp = newTexture->loadTextureFromImage(file_path, backgroundColor);
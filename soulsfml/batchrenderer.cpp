@@ -0,0 +1,77 @@
+#include "batchrenderer.h"
+#include "profiler.h"
+
+#include <cmath>
+#include <numbers>
+
+using namespace soul;
+
+void BatchRenderer::setTexture(uint32_t id, const std::shared_ptr<Texture2d>& texture) {
+    if (id >= _textures.size()) {
+        _textures.resize(id + 1);
+        _batches.resize(id + 1);
+    }
+    _textures[id] = texture;
+}
+
+void BatchRenderer::build(const ecs::World& world) {
+    SOUL_PROFILE_SCOPE("BatchRenderer::build");
+
+    for (auto& batch : _batches)
+        batch.clear();
+
+    world.forEachChunk<ecs::Transform, ecs::Sprite>([this](size_t count, const ecs::EntityId*,
+        const ecs::Transform* transforms, const ecs::Sprite* sprites) {
+
+        for (size_t i = 0; i < count; ++i) {
+            const ecs::Sprite& sprite = sprites[i];
+            if (sprite.texture >= _batches.size() || !_textures[sprite.texture])
+                continue;
+
+            const ecs::Transform& transform = transforms[i];
+            const float halfWidth = 0.5f * sprite.width * transform.scale;
+            const float halfHeight = 0.5f * sprite.height * transform.scale;
+
+            // Corners relative to the center, rotated only when needed
+            sf::Vector2f right(halfWidth, 0.0f);
+            sf::Vector2f down(0.0f, halfHeight);
+            if (transform.rotation != 0.0f) {
+                const float radians = transform.rotation * std::numbers::pi_v<float> / 180.0f;
+                const float c = std::cos(radians);
+                const float s = std::sin(radians);
+                right = sf::Vector2f(halfWidth * c, halfWidth * s);
+                down = sf::Vector2f(-halfHeight * s, halfHeight * c);
+            }
+
+            const sf::Vector2f center(transform.x, transform.y);
+            const sf::Vector2f topLeft = center - right - down;
+            const sf::Vector2f topRight = center + right - down;
+            const sf::Vector2f bottomRight = center + right + down;
+            const sf::Vector2f bottomLeft = center - right + down;
+
+            const float u0 = sprite.u, v0 = sprite.v;
+            const float u1 = sprite.u + sprite.width, v1 = sprite.v + sprite.height;
+
+            // Two triangles per quad
+            std::vector<sf::Vertex>& batch = _batches[sprite.texture];
+            batch.push_back(sf::Vertex {topLeft, sf::Color::White, {u0, v0}});
+            batch.push_back(sf::Vertex {topRight, sf::Color::White, {u1, v0}});
+            batch.push_back(sf::Vertex {bottomRight, sf::Color::White, {u1, v1}});
+            batch.push_back(sf::Vertex {topLeft, sf::Color::White, {u0, v0}});
+            batch.push_back(sf::Vertex {bottomRight, sf::Color::White, {u1, v1}});
+            batch.push_back(sf::Vertex {bottomLeft, sf::Color::White, {u0, v1}});
+        }
+    });
+}
+
+void BatchRenderer::render(GameWindow& gw) const {
+    SOUL_PROFILE_SCOPE("BatchRenderer::render");
+
+    for (size_t id = 0; id < _batches.size(); ++id) {
+        if (_batches[id].empty())
+            continue;
+        sf::RenderStates states;
+        states.texture = &_textures[id]->getTexture();
+        gw.draw(_batches[id].data(), _batches[id].size(), sf::PrimitiveType::Triangles, states);
+    }
+}
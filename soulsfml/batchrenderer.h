@@ -0,0 +1,38 @@
+#pragma once
+
+#include "world.h"
+#include "gamewindow.h"
+#include "texture2d.h"
+
+#include <memory>
+#include <vector>
+
+#include <SFML/Graphics/Vertex.hpp>
+
+namespace soul {
+
+/**
+ * @brief BatchRenderer class
+ * Draws the ECS entities having a Transform and a Sprite: their quads are written
+ * chunk by chunk in one vertex array per texture, so a whole texture is a single draw call
+ * whatever the number of entities. The quad is centered on the transform.
+ * The vertex arrays are kept between frames, only their content is rebuilt.
+ * build() only reads the World and may run on a worker, render() draws on the window thread.
+ */
+class BatchRenderer {
+public:
+    // Texture of the sprites whose Sprite::texture is id
+    void setTexture(uint32_t id, const std::shared_ptr<Texture2d>& texture);
+
+    // Rebuilds the vertex arrays from the current transforms and sprites
+    void build(const ecs::World& world);
+
+    // Draws the vertex arrays of the last build
+    void render(GameWindow& gw) const;
+
+private:
+    std::vector<std::shared_ptr<Texture2d>> _textures;
+    std::vector<std::vector<sf::Vertex>> _batches;
+};
+
+} // namespace soul
@@ -141,11 +141,11 @@ bool Canvas::update(float dt) {
 }
 
 void Canvas::render() {
-    if (_background.get() != nullptr) _scene.gw.window.draw(_background->getSprite());
+    if (_background.get() != nullptr) _scene.gw.draw(_background->getSprite());
 
     if (_text.get() != nullptr) {
-        _scene.gw.window.draw(*_text.get());
-        _scene.gw.window.draw(*_lifeText.get());
+        _scene.gw.draw(*_text.get());
+        _scene.gw.draw(*_lifeText.get());
     }
 
     // Update the health bar in the screen
@@ -155,8 +155,8 @@ void Canvas::render() {
 
     _foregroundBar->setSize(sf::Vector2f(_props.hbarWidth * healthPercentage, _props.hbarHeight));
 
-    _scene.gw.window.draw(*_backgroundBar);
-    _scene.gw.window.draw(*_foregroundBar);
+    _scene.gw.draw(*_backgroundBar);
+    _scene.gw.draw(*_foregroundBar);
 
     // drawFireBar(totalTime.asSeconds());
 }
@@ -1,74 +1,360 @@
 
 #include "entitymanager.h"
+#include "perfcounters.h"
 
-#include <iostream>
-#include <fstream>
+#include <algorithm>
+#include <utility>
 
 using namespace soul;
 
+// Log channel of the entities
+static const LogCategory s_logEntities = LoggerManager::getInstance().registerCategory("Entities");
+
+namespace {
+
+// Command buffer of the chunk the calling thread is updating, nullptr outside the parallel phase
+thread_local EntityCommandBuffer* t_commands = nullptr;
+
+// Records the changes of the entity updates in commands for the scope
+struct RecordingScope {
+    explicit RecordingScope(EntityCommandBuffer& commands) : previous(std::exchange(t_commands, &commands)) {}
+    ~RecordingScope() { t_commands = previous; }
+
+    EntityCommandBuffer* previous;
+};
+
+} // namespace
+
+EntityView::EntityView(EntityQuery query) : _query(std::move(query)), _anyTag(_query.tags.empty()) {
+    for (const TagId tag : _query.tags) {
+        if (tag >= _tags.size())
+            _tags.resize(tag + 1, 0);
+        _tags[tag] = 1;
+    }
+}
+
+void EntityView::refresh(Entity& e) {
+    const bool listed = e.handle().index < _positions.size() && _positions[e.handle().index] != NOT_IN_VIEW;
+    if (matches(e) && !listed)
+        insert(e);
+    else if (!matches(e) && listed)
+        erase(e);
+}
+
+void EntityView::insert(Entity& e) {
+    const uint32_t slot = e.handle().index;
+    if (slot >= _positions.size())
+        _positions.resize(slot + 1, NOT_IN_VIEW);
+    _positions[slot] = static_cast<uint32_t>(_entities.size());
+    _entities.push_back(&e);
+}
+
+void EntityView::erase(const Entity& e) {
+    const uint32_t slot = e.handle().index;
+    if (slot >= _positions.size() || _positions[slot] == NOT_IN_VIEW)
+        return;
+
+    // Swap and pop, the last entity takes the position
+    const uint32_t position = _positions[slot];
+    Entity* last = _entities.back();
+    _entities[position] = last;
+    _positions[last->handle().index] = position;
+    _entities.pop_back();
+    _positions[slot] = NOT_IN_VIEW;
+}
+
+void EntityView::clear() {
+    _entities.clear();
+    _positions.clear();
+}
+
 std::vector<std::shared_ptr<soul::Entity>>& EntityManager::getEntities(const std::string& tag) {
-    std::map<string, vector<std::shared_ptr<soul::Entity>>>::iterator it = _mapEntities.find(tag);
-    if (it == _mapEntities.end()) {
-        // we create a new empty vector
-        std::cout << "Creating new Vector " << tag << endl;
-        std::vector<std::shared_ptr<soul::Entity>> v;
-        _mapEntities[tag] = v;
+    return getEntities(_tags.intern(tag));
+}
+
+void EntityManager::addEntity(const std::shared_ptr<soul::Entity>& e) {
+    if (t_commands) {
+        t_commands->spawn(e);
+        return;
+    }
+    _spawnQueue.push(e);
+}
+
+void EntityManager::kill(EntityHandle handle) {
+    if (t_commands) {
+        t_commands->kill(handle);
+        return;
+    }
+    if (Entity* e = get(handle))
+        e->setActive(false);
+}
+
+void EntityManager::setTag(Entity& e, TagId tag) {
+    // Not committed yet, it is listed under its tag by the next update
+    if (t_commands && e._handle.isValid()) {
+        t_commands->setTag(e._handle, tag);
+        return;
+    }
+    applyTag(e, tag);
+}
+
+void EntityManager::setFlags(Entity& e, EntityFlags flags) {
+    if (t_commands && e._handle.isValid()) {
+        t_commands->setFlags(e._handle, flags);
+        return;
+    }
+    applyFlags(e, flags);
+}
+
+void EntityManager::applyFlags(Entity& e, EntityFlags flags) {
+    if (e._flags == flags)
+        return;
+
+    e._flags = flags;
+    if (e._handle.isValid()) {
+        for (const auto& view : _views)
+            view->refresh(e);
+    }
+}
+
+EntityView& EntityManager::createView(EntityQuery query) {
+    _views.push_back(std::make_unique<EntityView>(std::move(query)));
+    EntityView& view = *_views.back();
+    for (const auto& e : _entities) {
+        if (view.matches(*e))
+            view.insert(*e);
+    }
+    return view;
+}
+
+void EntityManager::removeView(const EntityView& view) {
+    std::erase_if(_views, [&view](const std::unique_ptr<EntityView>& v) { return v.get() == &view; });
+}
+
+void EntityManager::applyTag(Entity& e, TagId tag) {
+    if (e._tagId == tag)
+        return;
+
+    if (e._handle.isValid()) {
+        std::vector<std::shared_ptr<Entity>>& from = _entitiesByTag[e._tagId];
+        std::shared_ptr<Entity> moved = from[e._tagIndex];
+        removeAt(from, &Entity::_tagIndex, e._tagIndex);
+        std::vector<std::shared_ptr<Entity>>& to = getEntities(tag);
+        e._tagIndex = static_cast<uint32_t>(to.size());
+        to.push_back(std::move(moved));
+    }
+    e._tagId = tag;
+    e._tag = &_tags.name(tag);
+
+    if (e._handle.isValid()) {
+        for (const auto& view : _views)
+            view->refresh(e);
+    }
+}
 
-        it = _mapEntities.find(tag);
-        if (it == _mapEntities.end())
-            throw std::invalid_argument("could not find entity vector newly created with tag " + tag);
+EntityHandle EntityManager::acquireSlot(Entity* e) {
+    if (_freeSlots.empty()) {
+        _slots.push_back(Slot{e, 0});
+        return EntityHandle{static_cast<uint32_t>(_slots.size() - 1), 0};
     }
 
-    return it->second;
+    const uint32_t index = _freeSlots.back();
+    _freeSlots.pop_back();
+    _slots[index].entity = e;
+    return EntityHandle{index, _slots[index].generation};
+}
+
+void EntityManager::releaseSlot(Entity& e) {
+    Slot& slot = _slots[e._handle.index];
+    slot.entity = nullptr;
+    // Handles of the previous generation are now stale
+    slot.generation++;
+    _freeSlots.push_back(e._handle.index);
+    e._handle = EntityHandle{};
+}
+
+void EntityManager::onDeactivated(Entity& e) {
+    if (t_commands) {
+        t_commands->deactivated(e._handle);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_killMutex);
+    _killList.push_back(e._handle);
 }
 
-void EntityManager::addEntity(std::shared_ptr<soul::Entity>& e) {
-    // // Add the entity to the list created to prevent iterator invalidation
-    logManager.logDebug("Adding entity instance ID:{} tag:{} IsActive:{}", e->ID(), e->tag(), e->isActive());
-    _entitiesToAdd.push_back(e);
+void EntityManager::removeAt(std::vector<std::shared_ptr<Entity>>& entities, uint32_t Entity::* position, uint32_t index) {
+    if (index + 1 != entities.size()) {
+        entities[index] = std::move(entities.back());
+        (*entities[index]).*position = index;
+    }
+    entities.pop_back();
 }
 
 void EntityManager::removeDeadEntities() {
-    // Remove dead entities from _entities
-    size_t count_before = _entities.size();
-    _entities.erase(std::remove_if(_entities.begin(), _entities.end(),
-        [](const std::shared_ptr<Entity>& e) {
-            return (!e->isActive());
-        }), _entities.end());
-
-    auto diff = count_before - _entities.size();
-    if (diff > 0) {
-        logManager.logDebug("{} entities removed.", diff);
-    }
-
-    // Remove dead entities from _mapEntities
-    for (auto it = _mapEntities.begin(); it != _mapEntities.end(); ) {
-        it->second.erase(std::remove_if(it->second.begin(), it->second.end(),
-            [](const std::shared_ptr<Entity>& e) {
-                return (!e->isActive());
-            }), it->second.end());
-
-        // If no more entities remain under a tag, remove the tag
-        if (it->second.empty()) {
-            it = _mapEntities.erase(it);
-        } else {
-            ++it;
+    {
+        std::lock_guard<std::mutex> lock(_killMutex);
+        if (_killList.empty())
+            return;
+        _killing.swap(_killList);
+    }
+
+    size_t removed = 0;
+    for (const EntityHandle handle : _killing) {
+        // Removed already, or active again since it was killed
+        Entity* e = get(handle);
+        if (!e || e->isActive())
+            continue;
+
+        // Keep the entity alive until it is out of both lists
+        std::shared_ptr<Entity> dead = _entities[e->_denseIndex];
+        removeAt(_entities, &Entity::_denseIndex, e->_denseIndex);
+        removeAt(_entitiesByTag[e->_tagId], &Entity::_tagIndex, e->_tagIndex);
+        for (const auto& view : _views)
+            view->erase(*e);
+        e->_observer = nullptr;
+        releaseSlot(*e);
+        ++removed;
+    }
+    _killing.clear();
+
+    if (removed > 0) {
+        logManager.log(s_logEntities, LOG_LEVEL::LOG_DEBUG, "{} entities removed.", removed);
+    }
+}
+
+void EntityManager::addSpawnedEntities() {
+    // One batch per frame, in the order of each spawning thread
+    _spawnQueue.drain([this](std::shared_ptr<Entity>&& e) {
+        // Dead before it was ever committed
+        if (e->isActive())
+            _entitiesToAdd.push_back(std::move(e));
+    });
+    if (_entitiesToAdd.empty())
+        return;
+
+    // Room for the batch in every list first, then plain appends
+    _entities.reserve(_entities.size() + _entitiesToAdd.size());
+    _spawnedPerTag.assign(_entitiesByTag.size(), 0);
+    for (const auto& e : _entitiesToAdd) {
+        if (e->tagId() >= _spawnedPerTag.size())
+            _spawnedPerTag.resize(e->tagId() + 1, 0);
+        _spawnedPerTag[e->tagId()]++;
+    }
+    for (TagId tag = 0; tag < _spawnedPerTag.size(); ++tag) {
+        if (_spawnedPerTag[tag] > 0) {
+            std::vector<std::shared_ptr<Entity>>& tagged = getEntities(tag);
+            tagged.reserve(tagged.size() + _spawnedPerTag[tag]);
         }
     }
+
+    for (auto& e : _entitiesToAdd) {
+        std::vector<std::shared_ptr<Entity>>& tagged = _entitiesByTag[e->tagId()];
+        e->_handle = acquireSlot(e.get());
+        e->_denseIndex = static_cast<uint32_t>(_entities.size());
+        e->_tagIndex = static_cast<uint32_t>(tagged.size());
+        e->_observer = this;
+        tagged.push_back(e);
+        for (const auto& view : _views) {
+            if (view->matches(*e))
+                view->insert(*e);
+        }
+        _entities.push_back(std::move(e));
+    }
+
+    logManager.log(s_logEntities, LOG_LEVEL::LOG_DEBUG, "{} entities added.", _entitiesToAdd.size());
+    _entitiesToAdd.clear();
+}
+
+void EntityManager::updateRange(EntityCommandBuffer& commands, size_t begin, size_t end, float dt) {
+    RecordingScope recording(commands);
+    for (size_t i = begin; i < end; ++i) {
+        Entity& e = *_entities[i];
+        if (e.isActive() && !e.update(dt))
+            e.setActive(false);
+    }
+}
+
+void EntityManager::updateEntities(JobSystem& jobs, float dt) {
+    SOUL_PROFILE_COUNTERS("EntityManager::updateEntities", _entities.size());
+
+    // Fixed chunks, so the buffers do not depend on the workers running them
+    const size_t chunks = (_entities.size() + UPDATE_GRAIN - 1) / UPDATE_GRAIN;
+    if (_commandBuffers.size() < chunks)
+        _commandBuffers.resize(chunks);
+    for (size_t chunk = 0; chunk < chunks; ++chunk)
+        _commandBuffers[chunk].clear();
+
+    jobs.parallelFor(chunks, 1, [this, dt](size_t begin, size_t end) {
+        for (size_t chunk = begin; chunk < end; ++chunk) {
+            const size_t first = chunk * UPDATE_GRAIN;
+            updateRange(_commandBuffers[chunk], first, std::min(first + UPDATE_GRAIN, _entities.size()), dt);
+        }
+    });
+    applyCommands(chunks);
+}
+
+void EntityManager::updateEntities(float dt) {
+    SOUL_PROFILE_COUNTERS("EntityManager::updateEntities", _entities.size());
+
+    if (_commandBuffers.empty())
+        _commandBuffers.resize(1);
+    _commandBuffers[0].clear();
+    updateRange(_commandBuffers[0], 0, _entities.size(), dt);
+    applyCommands(1);
+}
+
+void EntityManager::applyCommands(size_t buffers) {
+    for (size_t i = 0; i < buffers; ++i) {
+        for (const EntityCommandBuffer::Command& command : _commandBuffers[i]) {
+            switch (command.type) {
+                case EntityCommandBuffer::Type::Spawn:
+                    _spawnQueue.push(command.entity);
+                    break;
+                case EntityCommandBuffer::Type::Kill:
+                    kill(command.handle);
+                    break;
+                case EntityCommandBuffer::Type::Deactivated: {
+                    std::lock_guard<std::mutex> lock(_killMutex);
+                    _killList.push_back(command.handle);
+                    break;
+                }
+                case EntityCommandBuffer::Type::SetTag:
+                    if (Entity* e = get(command.handle))
+                        applyTag(*e, command.tag);
+                    break;
+                case EntityCommandBuffer::Type::SetFlags:
+                    if (Entity* e = get(command.handle))
+                        applyFlags(*e, command.flags);
+                    break;
+            }
+        }
+        _commandBuffers[i].clear();
+    }
 }
 
 void EntityManager::update()
 {
-    // Add the new entities in the containers
-    for (auto e : _entitiesToAdd) {
-        std::cout << "Add Entity " << e->tag() << " to map entities" << endl; 
-        _entities.push_back(e);
-        _mapEntities[e->tag()].push_back(e);
-    }
-    _entitiesToAdd.clear();
+    SOUL_PROFILE_COUNTERS("EntityManager::update", _entities.size());
+
+    // Entities spawned since the last update, from any thread
+    addSpawnedEntities();
 
-    // Need to delete all entities declared as dead
-    // store the index and the tag for each dead entity
-    // then iterate through them and erase
+    // Entities deactivated since the last update, nothing to do when none died
     removeDeadEntities();
-}
\ No newline at end of file
+}
+
+void EntityManager::clear() {
+    for (const auto& e : _entities) {
+        e->_observer = nullptr;
+        releaseSlot(*e);
+    }
+    {
+        std::lock_guard<std::mutex> lock(_killMutex);
+        _killList.clear();
+    }
+    _spawnQueue.drain([](std::shared_ptr<Entity>&&) {});
+    for (const auto& view : _views)
+        view->clear();
+    _entities.clear();
+    _entitiesByTag.clear();
+}
@@ -2,7 +2,6 @@
 
 #include <memory>
 #include <vector>
-#include <map>
 #include <assert.h>
 #include <mutex>
 #include <optional>
@@ -10,14 +9,129 @@
 #include "singleton.h"
 #include "logger.h"
 #include "entity.h"
+#include "taginterner.h"
+#include "mpscqueue.h"
+#include "jobsystem.h"
 
 namespace soul {
 
+/**
+ * @brief Structural changes recorded by the entity updates of the parallel phase,
+ * applied by the EntityManager once every update is done.
+ */
+class EntityCommandBuffer {
+public:
+    enum class Type : uint8_t {
+        // New entity, committed by the next update()
+        Spawn,
+        // Entity deactivated by another one
+        Kill,
+        // Entity which deactivated itself, it goes on the kill list
+        Deactivated,
+        // Entity moved to another tag
+        SetTag,
+        // New flags of the entity
+        SetFlags
+    };
+
+    struct Command {
+        Type type;
+        EntityHandle handle;
+        TagId tag {0};
+        std::shared_ptr<Entity> entity;
+        EntityFlags flags {0};
+    };
+
+    void spawn(const std::shared_ptr<Entity>& e) { _commands.push_back(Command{Type::Spawn, {}, 0, e}); }
+    void kill(EntityHandle handle) { _commands.push_back(Command{Type::Kill, handle, 0, nullptr}); }
+    void deactivated(EntityHandle handle) { _commands.push_back(Command{Type::Deactivated, handle, 0, nullptr}); }
+    void setTag(EntityHandle handle, TagId tag) { _commands.push_back(Command{Type::SetTag, handle, tag, nullptr}); }
+    void setFlags(EntityHandle handle, EntityFlags flags) { _commands.push_back(Command{Type::SetFlags, handle, 0, nullptr, flags}); }
+
+    bool empty() const { return _commands.empty(); }
+    size_t size() const { return _commands.size(); }
+    void clear() { _commands.clear(); }
+
+    std::vector<Command>::const_iterator begin() const { return _commands.begin(); }
+    std::vector<Command>::const_iterator end() const { return _commands.end(); }
+
+private:
+    std::vector<Command> _commands;
+};
+
+// Entities a view selects
+struct EntityQuery {
+    // Any of these tags, every tag when empty
+    std::vector<TagId> tags;
+    // Flags every entity must have
+    EntityFlags flags {0};
+};
+
+/**
+ * @brief Entities of the EntityManager matching a query, in a dense array.
+ * The manager keeps every view up to date when entities are committed, removed, or change
+ * their tag or flags, so iterating a view is a plain loop over the matching entities without
+ * tests. An entity deactivated leaves its views with the kill list, at the next update.
+ */
+class EntityView {
+public:
+    explicit EntityView(EntityQuery query);
+
+    bool matches(const Entity& e) const {
+        const TagId tag = e.tagId();
+        return (_anyTag || (tag < _tags.size() && _tags[tag])) && e.hasFlags(_query.flags);
+    }
+
+    const EntityQuery& query() const { return _query; }
+
+    size_t size() const { return _entities.size(); }
+    bool empty() const { return _entities.empty(); }
+
+    std::vector<Entity*>::const_iterator begin() const { return _entities.begin(); }
+    std::vector<Entity*>::const_iterator end() const { return _entities.end(); }
+
+    Entity* operator[](size_t i) const { return _entities[i]; }
+
+private:
+    friend class EntityManager;
+
+    static constexpr uint32_t NOT_IN_VIEW = ~0u;
+
+    // Adds or removes the committed entity after a change
+    void refresh(Entity& e);
+    void insert(Entity& e);
+    void erase(const Entity& e);
+    void clear();
+
+private:
+    EntityQuery _query;
+    bool _anyTag;
+    // Flag per TagId of the query
+    std::vector<uint8_t> _tags;
+    std::vector<Entity*> _entities;
+    // Position in _entities per slot of the manager
+    std::vector<uint32_t> _positions;
+};
+
 /**
  * @brief EntityManager class
  * ECS like entity manager for managing entities in the game
+ * addEntity() may be called from any thread: the entity goes on a lock-free spawn queue,
+ * drained in one batch by update() on the game thread.
+ * Entities added are committed by update(), which gives them a handle: a slot from
+ * a free list and the generation of the slot. get(handle) is an index and a compare,
+ * the generation of a slot changes when its entity is removed so stale handles return nullptr.
+ * Entities deactivated are pushed on a kill list and removed by the next update in O(dead):
+ * each entity knows its positions in the lists and the last entity is swapped in its place,
+ * so the order of the lists is not kept. A frame without deaths skips the removal.
+ * updateEntities() calls the update of every entity, in chunks of UPDATE_GRAIN entities on the workers
+ * of a JobSystem. An update only changes its own entity: while it runs, addEntity(), kill(), setTag(),
+ * setFlags() and its own deactivation are recorded in the command buffer of its chunk, and the buffers are
+ * applied in chunk order after the phase. That is the order of a serial update whatever the
+ * workers did, so the lists end up the same, entity for entity, as with the serial updateEntities().
+ * Systems iterate an EntityView from createView() instead of filtering a list every frame.
  */
-class EntityManager : public SingletonT<EntityManager> {
+class EntityManager : public SingletonT<EntityManager>, public IEntityObserver {
 
     MAKE_SINGLETON(EntityManager)
 
@@ -25,22 +139,113 @@ private:
     LoggerManager& logManager = LoggerManager::getInstance();
 
     std::vector<std::shared_ptr<Entity>> _entities;
+    // Spawned from any thread, drained by update()
+    MpscQueue<std::shared_ptr<Entity>> _spawnQueue;
     std::vector<std::shared_ptr<Entity>> _entitiesToAdd;
-    std::map<std::string, std::vector<std::shared_ptr<Entity>>> _mapEntities;
+    std::vector<uint32_t> _spawnedPerTag;
+    // Entities per tag, indexed by TagId
+    std::vector<std::vector<std::shared_ptr<Entity>>> _entitiesByTag;
+    TagInterner& _tags = TagInterner::getInstance();
+
+    struct Slot {
+        Entity* entity {nullptr};
+        uint32_t generation {0};
+    };
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+
+    // Entities deactivated since the last update, from any thread
+    std::mutex _killMutex;
+    std::vector<EntityHandle> _killList;
+    std::vector<EntityHandle> _killing;
+
+    // One per chunk of the parallel update, kept between frames
+    std::vector<EntityCommandBuffer> _commandBuffers;
+
+    // Views kept up to date, stable addresses
+    std::vector<std::unique_ptr<EntityView>> _views;
 
 public:
+    // Entities per chunk of the parallel update
+    static constexpr size_t UPDATE_GRAIN = 256;
+
     _ALWAYS_INLINE_ size_t getTotalEntities() const { return _entities.size(); }
 
     _ALWAYS_INLINE_ std::vector<std::shared_ptr<Entity>>& getEntities() { return _entities; }
 
+    // Entities of a tag, O(1)
+    _ALWAYS_INLINE_ std::vector<std::shared_ptr<Entity>>& getEntities(TagId tag) {
+        if (tag >= _entitiesByTag.size())
+            _entitiesByTag.resize(tag + 1);
+        return _entitiesByTag[tag];
+    }
+
+    // Interns the tag, prefer the TagId overload on the hot path
     std::vector<std::shared_ptr<Entity>>& getEntities(const std::string& tag);
 
-    void addEntity(std::shared_ptr<Entity>& e);
+    // Calls f(tag, count) for every tag having entities
+    template<typename F>
+    void forEachTag(F&& f) const {
+        for (TagId tag = 0; tag < _entitiesByTag.size(); ++tag) {
+            if (!_entitiesByTag[tag].empty())
+                f(_tags.name(tag), _entitiesByTag[tag].size());
+        }
+    }
+
+    // Entity of the handle, nullptr when it was removed or the handle is invalid
+    _ALWAYS_INLINE_ Entity* get(EntityHandle handle) const {
+        if (handle.index >= _slots.size())
+            return nullptr;
+        const Slot& slot = _slots[handle.index];
+        return slot.generation == handle.generation ? slot.entity : nullptr;
+    }
+
+    _ALWAYS_INLINE_ bool isAlive(EntityHandle handle) const { return get(handle) != nullptr; }
+
+    // Thread safe, the entity is committed by the next update
+    void addEntity(const std::shared_ptr<Entity>& e);
+
+    // Deactivates the entity, recorded when called from an entity update
+    void kill(EntityHandle handle);
+
+    // Moves the entity to the list of another tag, game thread or entity update only
+    void setTag(Entity& e, TagId tag);
+
+    // Changes the flags of the entity, game thread or entity update only
+    void setFlags(Entity& e, EntityFlags flags);
+
+    // View of the entities matching the query, filled with the current ones, valid until removed
+    EntityView& createView(EntityQuery query);
+    void removeView(const EntityView& view);
+
+    // Updates every active entity on the workers, then applies their commands
+    void updateEntities(JobSystem& jobs, float dt);
+
+    // Same result on the calling thread
+    void updateEntities(float dt);
 
     void update();
 
+    // Removes every entity, their handles become stale
+    void clear();
+
+    void onDeactivated(Entity& e) override;
+
 private:
+    void addSpawnedEntities();
     void removeDeadEntities();
+
+    // Updates the entities [begin, end) recording their changes in commands
+    void updateRange(EntityCommandBuffer& commands, size_t begin, size_t end, float dt);
+    void applyCommands(size_t buffers);
+    void applyTag(Entity& e, TagId tag);
+    void applyFlags(Entity& e, EntityFlags flags);
+
+    // Swap and pop of the entity in a list, using the position stored in the entity
+    void removeAt(std::vector<std::shared_ptr<Entity>>& entities, uint32_t Entity::* position, uint32_t index);
+
+    EntityHandle acquireSlot(Entity* e);
+    void releaseSlot(Entity& e);
 };
 
 } // namespace soul
\ No newline at end of file
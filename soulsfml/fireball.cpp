@@ -5,8 +5,13 @@
 #include "gamewindow.h"
 #include "loaders.h"
 
+#include <algorithm>
+
 using namespace soul;
 
+// Log channel of the fireballs
+static const LogCategory s_logFireballs = LoggerManager::getInstance().registerCategory("Fireballs");
+
 Fireball::Fireball(
     FireballSystem& system,
     const std::string& tag, 
@@ -28,7 +33,7 @@ Fireball::Fireball(
 }
 
 void Fireball::reset(int index) {
-    std::cout << std::format("Fireball::reset Index={}", index) << std::endl;
+    SOUL_LOG_EVERY_INTERVAL(logManager, std::chrono::milliseconds(1000), LOG_LEVEL::LOG_DEBUG, "Fireball::reset Index={}", index);
 
     const auto& player = _system.getPlayer();
     const soul::Vector2f& pos = player.getPosition();
@@ -68,7 +73,7 @@ bool Fireball::update(float dt) {
 
     // If lifetime expires, mark the bullet as dead
     if (_metrics.current_lifetime <= 0.001f) {
-        std::cout << "Fireball is dead now, disabling it" << std::endl;
+        SOUL_LOG_EVERY_N(logManager, 100, LOG_LEVEL::LOG_DEBUG, "Fireball {} is dead now, disabling it", ID());
         setActive(false);
         _system.signalShoot();
         return isActive();
@@ -91,38 +96,79 @@ void Fireball::render() {
     // gw.window.draw(this->getSprite(), &_fireballShader.shader);
 
     if (isActive())
-       gw.window.draw(this->getSprite());
+       gw.draw(this->getSprite());
+}
+
+FireballSystem::~FireballSystem() {
+    for (auto& thread : _resetThreads)
+        thread.request_stop();
+    // Wake them up to see the stop request, then join before the fireballs go back to the pool
+    _shot.fetch_add(1, std::memory_order_release);
+    _shot.notify_all();
+    _resetThreads.clear();
 }
 
 void FireballSystem::initFireballs(Player* player, const std::string& filePath, float speedX, float lifetime) {
     _player = player;
+    // Back to the pool before the new ones are acquired, the reset threads
+    // only see the fireballs handed over by latchFireballs
     _fireballs.clear();
     _fireballs = VectorLoader<Fireball>::load(filePath, _thr_fireball_count, *player);
+
+    startResetThreads();
+}
+
+void FireballSystem::startResetThreads() {
+    // One thread per fireball loaded, the ones already running are kept
+    const size_t count = std::min(_fireballs.size(), static_cast<size_t>(_thr_fireball_count));
+    // Read here, a shot before a thread first runs is not missed
+    const uint32_t shot = _shot.load(std::memory_order_acquire);
+    _resetThreads.reserve(count);
+    for (int i = static_cast<int>(_resetThreads.size()); i < static_cast<int>(count); ++i)
+        _resetThreads.emplace_back([this, i, shot](std::stop_token stop) { resetLoop(stop, i, shot); });
+}
+
+void FireballSystem::resetLoop(std::stop_token stop, int index, uint32_t seen) {
+    while (true) {
+        _shot.wait(seen, std::memory_order_acquire);
+        if (stop.stop_requested())
+            return;
+        seen = _shot.load(std::memory_order_acquire);
+
+        // Entity is active now
+        // Update data in the entity before rendering it
+        if (Fireball* fireball = _shotFireballs[index])
+            fireball->reset(index);
+
+        if (_pendingResets.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            _pendingResets.notify_one();
+    }
 }
 
 void FireballSystem::latchFireballs() {       
-    // Create a latch with predefined number of threads to run in parallel
-    // _thr_fireball_count: Number of Fireballs to create
+    // Wake the reset threads, one per fireball, and wait until they all reset their fireball
+    // _thr_fireball_count: Number of Fireballs to reset
 
-// #ifdef DEBUG_MODE_STATES
-logManager.log("{} fireballs to latch", _thr_fireball_count);
-// #endif
+    logManager.log(s_logFireballs, LOG_LEVEL::LOG_DEBUG, "{} fireballs to latch", _thr_fireball_count);
 
-    std::latch latch(_thr_fireball_count);
+    // Nothing to reset before initFireballs
+    if (_resetThreads.empty())
+        return;
 
-    std::vector<std::jthread> jthreads;
-    for (int i = 0; i < _thr_fireball_count; ++i) {
-        jthreads.emplace_back(
-            [this, &latch, i]() { 
-                // Entity is active now
-                // Update data in the entity before rendering it
-                _fireballs[i]->reset(i);
+    // Published by the release below, not touched again before all the threads counted down
+    const size_t count = _resetThreads.size();
+    for (size_t i = 0; i < count; ++i)
+        _shotFireballs[i] = i < _fireballs.size() ? _fireballs[i].get() : nullptr;
 
-            latch.count_down();  // Decrease latch counter
-        });
-    }
+    _pendingResets.store(static_cast<int>(count), std::memory_order_relaxed);
+    _shot.fetch_add(1, std::memory_order_release);
+    _shot.notify_all();
 
-    latch.wait();  // Wait until all threads call count_down()
+    // Wait until all threads counted down
+    for (int pending = _pendingResets.load(std::memory_order_acquire); pending != 0;
+         pending = _pendingResets.load(std::memory_order_acquire)) {
+        _pendingResets.wait(pending, std::memory_order_acquire);
+    }
 }
 
 void FireballSystem::signalShoot() {
@@ -131,9 +177,7 @@ void FireballSystem::signalShoot() {
 
     if (_thr_current_count_fireball.get() == _thr_fireball_count) {
 
-#ifdef DEBUG_MODE_STATES
-        logManager.logDebug("Signal shoot reached {} fireballs. Re-enable shoot.", _thr_fireball_count);
-#endif
+        logManager.log(s_logFireballs, LOG_LEVEL::LOG_DEBUG, "Signal shoot reached {} fireballs. Re-enable shoot.", _thr_fireball_count);
 
         _thr_current_count_fireball.set(0);
         
@@ -4,8 +4,13 @@
 #include "spriteanimation.h"
 #include "pathmanager.h"
 #include "shader.h"
+#include "objectpool.h"
 
-#include <latch>
+#include <array>
+#include <atomic>
+#include <stop_token>
+#include <thread>
+#include <vector>
 
 namespace soul {
 
@@ -80,21 +85,42 @@ private:
     Player* _player;    
     // Number of fireballs to shoot
     static constexpr int _thr_fireball_count = 2;
-    // Container for poolables (flyweight)
+    // Storage of the fireballs, one slab for all of them
+    ObjectPool<Fireball> _pool {_thr_fireball_count, PoolGrowth::Fixed};
+    // Container for poolables (flyweight), released to the pool
     std::vector<std::shared_ptr<Fireball>> _fireballs;
     // Atomic counter variable used as lock for fireball shots
     // std::atomic<int> _thr_current_count_fireball{0};
     SafeNumeric<int> _thr_current_count_fireball{0};
+    // Persistent threads resetting the fireballs of a shot, one per fireball:
+    // a shot wakes them instead of creating threads, it does not allocate
+    std::vector<std::jthread> _resetThreads;
+    // Bumped for every shot, the reset threads wait on it
+    std::atomic<uint32_t> _shot {0};
+    // Fireballs of the current shot not reset yet, used as latch
+    std::atomic<int> _pendingResets {0};
+    // Fireball of each reset thread for the current shot, handed over with _shot:
+    // the threads never read _fireballs, which initFireballs replaces
+    std::array<Fireball*, _thr_fireball_count> _shotFireballs {};
+
+    void startResetThreads();
+    // Resets the fireball index at every shot after the seen one
+    void resetLoop(std::stop_token stop, int index, uint32_t seen);
         
 public:
     FireballSystem() : _player(nullptr) {}
-    ~FireballSystem() = default;
+    ~FireballSystem();
 
     const Player& getPlayer() const { return *_player; } 
 
     int getFireballCount() const { return _thr_fireball_count; }
 
     const std::vector<std::shared_ptr<Fireball>>& getFireballs() const { return _fireballs; }
+
+    ObjectPool<Fireball>& getPool() { return _pool; }
+    const ObjectPoolStats& getPoolStats() const { return _pool.stats(); }
+
+    size_t getResetThreadCount() const { return _resetThreads.size(); }
     
     void initFireballs(Player* player, const std::string& filePath, float speedX, float lifetime);
 
@@ -13,6 +13,7 @@
 #include "imgui.h" // necessary for ImGui::*, imgui-SFML.h doesn't include imgui.h
 #include "imgui-SFML.h" // for ImGui::SFML::* functions and SFML-specific overloads
 
+#include "core.h"
 #include "singleton.h"
 #include "logger.h"
 
@@ -45,11 +46,26 @@ public:
         bool p_fullscreen, 
         int p_frameRateLimit);
 
+    // Draw on the window, counted for the Performance window
+    void draw(const sf::Drawable& drawable, const sf::RenderStates& states = sf::RenderStates::Default) {
+        window.draw(drawable, states);
+        ++_drawCalls;
+    }
+
+    void draw(const sf::Vertex* vertices, size_t count, sf::PrimitiveType type, const sf::RenderStates& states = sf::RenderStates::Default) {
+        window.draw(vertices, count, type, states);
+        ++_drawCalls;
+    }
+
+    _ALWAYS_INLINE_ uint32_t getDrawCalls() const { return _drawCalls; }
+    _ALWAYS_INLINE_ void resetDrawCalls() { _drawCalls = 0; }
+
 public:
     sf::RenderWindow window;
 private:
     bool _fullscreen {false};
     bool _isShutdown {false};
+    uint32_t _drawCalls {0};
 };
 
 } // namespace soul
\ No newline at end of file
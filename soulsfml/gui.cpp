@@ -1,10 +1,144 @@
 #include "gui.h"
 #include "animable.h"
+#include "entitymanager.h"
+#include "assetmanager.h"
+#include "perfcounters.h"
 
 #include <SFML/Graphics/RenderWindow.hpp>
 
+#include <cstdarg>
+#include <cstdio>
+#include <algorithm>
+
 using namespace soul;
 
+namespace {
+
+// Names of the levels for the level combo, in LOG_LEVEL order
+const char* const s_levelNames[] = {
+#define X(name, color, str) str,
+    LOG_LEVELS
+#undef X
+};
+
+// Colours of the levels, matching the console colours
+ImVec4 levelColor(LOG_LEVEL level) {
+    switch (level) {
+        case LOG_LEVEL::LOG_DEBUGVERBOSE: return ImVec4(0.45f, 0.70f, 0.45f, 1.0f);
+        case LOG_LEVEL::LOG_DEBUG: return ImVec4(0.40f, 0.90f, 0.40f, 1.0f);
+        case LOG_LEVEL::LOG_INFO: return ImVec4(0.55f, 0.70f, 1.00f, 1.0f);
+        case LOG_LEVEL::LOG_WARNING: return ImVec4(1.00f, 0.65f, 0.10f, 1.0f);
+        case LOG_LEVEL::LOG_ERROR: return ImVec4(1.00f, 0.30f, 0.30f, 1.0f);
+        default: return ImVec4(1.0f, 1.0f, 1.0f, 1.0f);
+    }
+}
+
+} // namespace
+
+void GuiDebugLog::clear() {
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pending.clear();
+    }
+    for (auto& record : _records)
+        record.text.clear();
+    _count = 0;
+    _visible.clear();
+}
+
+void GuiDebugLog::addLog(LOG_LEVEL level, std::string_view text) {
+    // Lines are displayed one per row
+    if (!text.empty() && text.back() == '\n')
+        text.remove_suffix(1);
+
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+
+    // Records beyond the capacity would be overwritten by the next render anyway
+    if (_pending.size() >= _records.size())
+        _pending.pop_front();
+
+    _pending.push_back(LogRecord{level, std::string(text)});
+}
+
+void GuiDebugLog::addLog(const char* fmt, ...) {
+    char buf[1024];
+    va_list args;
+    va_start(args, fmt);
+    const int len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len < 0)
+        return;
+
+    addLog(LOG_LEVEL::LOG_INFO, std::string_view(buf, std::min<size_t>(len, sizeof(buf) - 1)));
+}
+
+bool GuiDebugLog::passFilter(const LogRecord& record) const {
+    if (static_cast<int>(record.level) < MinLevel)
+        return false;
+    return Filter.PassFilter(record.text.data(), record.text.data() + record.text.size());
+}
+
+void GuiDebugLog::drainPending() {
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        std::swap(_pending, _drained);
+    }
+
+    for (auto& pending : _drained) {
+        // Overwrite the oldest slot, the string keeps its capacity
+        auto& record = _records[_count % _records.size()];
+        record.level = pending.level;
+        record.text.assign(pending.text);
+
+        if (passFilter(record))
+            _visible.push_back(_count);
+        _count++;
+    }
+    _drained.clear();
+
+    // Forget the records which have been overwritten
+    const uint64_t first = oldest();
+    while (!_visible.empty() && _visible.front() < first)
+        _visible.pop_front();
+}
+
+void GuiDebugLog::rebuildIndex() {
+    _visible.clear();
+    for (uint64_t seq = oldest(); seq < _count; ++seq) {
+        if (passFilter(_records[seq % _records.size()]))
+            _visible.push_back(seq);
+    }
+}
+
+void GuiDebugLog::renderCategories() {
+    auto& logManager = LoggerManager::getInstance();
+
+    const size_t count = logManager.getCategoryCount();
+    if (count == 0)
+        return;
+
+    ImGui::SeparatorText("Categories");
+
+    // One line per category: enabled state and minimum level, applied immediately
+    for (size_t id = 0; id < count; ++id) {
+        const LogCategory category{static_cast<uint8_t>(id)};
+        ImGui::PushID(static_cast<int>(id));
+
+        bool enabled = logManager.isCategoryEnabled(category);
+        if (ImGui::Checkbox(logManager.categoryName(category).c_str(), &enabled))
+            logManager.setCategoryEnabled(category, enabled);
+
+        ImGui::SameLine(150.0f);
+        int level = static_cast<int>(logManager.getCategoryLevel(category));
+        ImGui::SetNextItemWidth(110.0f);
+        if (ImGui::Combo("##level", &level, s_levelNames, IM_ARRAYSIZE(s_levelNames)))
+            logManager.setCategoryLevel(category, static_cast<LOG_LEVEL>(level));
+
+        ImGui::PopID();
+    }
+}
+
 void GuiDebugLog::render(GameWindow& gw) {
 
     ImGui::SetNextWindowSize(ImVec2(400, 250), ImGuiCond_FirstUseEver);
@@ -18,6 +152,7 @@ void GuiDebugLog::render(GameWindow& gw) {
     // Options menu
     if (ImGui::BeginPopup("Options")) {
         ImGui::Checkbox("Auto-scroll", &AutoScroll);
+        renderCategories();
         ImGui::EndPopup();
     }
 
@@ -29,7 +164,10 @@ void GuiDebugLog::render(GameWindow& gw) {
     ImGui::SameLine();
     bool bt_copy = ImGui::Button("Copy");
     ImGui::SameLine();
-    Filter.Draw("Filter", -100.0f);
+    ImGui::SetNextItemWidth(100.0f);
+    FilterDirty |= ImGui::Combo("Level", &MinLevel, s_levelNames, IM_ARRAYSIZE(s_levelNames));
+    ImGui::SameLine();
+    FilterDirty |= Filter.Draw("Filter", -100.0f);
 
     ImGui::Separator();
 
@@ -39,46 +177,29 @@ void GuiDebugLog::render(GameWindow& gw) {
         if (bt_copy)
             ImGui::LogToClipboard();
 
-        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
-        const char* buf = Buf.begin();
-        const char* buf_end = Buf.end();
-        if (Filter.IsActive()) {
-        //     // In this example we don't use the clipper when Filter is enabled.
-        //     // This is because we don't have random access to the result of our filter.
-        //     // A real application processing logs with ten of thousands of entries may want to store the result of
-        //     // search/filter.. especially if the filtering function is not trivial (e.g. reg-exp).
-            for (int line_no = 0; line_no < LineOffsets.Size; line_no++) {
-                const char* line_start = buf + LineOffsets[line_no];
-                const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
-                if (Filter.PassFilter(line_start, line_end))
-                    ImGui::TextUnformatted(line_start, line_end);
-            }
+        // Only the new records are tested against the filter, unless the filter itself has changed
+        drainPending();
+        if (FilterDirty) {
+            rebuildIndex();
+            FilterDirty = false;
         }
-        else {
-            // The simplest and easy way to display the entire buffer:
-            //   ImGui::TextUnformatted(buf_begin, buf_end);
-            // And it'll just work. TextUnformatted() has specialization for large blob of text and will fast-forward
-            // to skip non-visible lines. Here we instead demonstrate using the clipper to only process lines that are
-            // within the visible area.
-            // If you have tens of thousands of items and their processing cost is non-negligible, coarse clipping them
-            // on your side is recommended. Using ImGuiListClipper requires
-            // - A) random access into your data
-            // - B) items all being the  same height,
-            // both of which we can handle since we have an array pointing to the beginning of each line of text.
-            // When using the filter (in the block of code above) we don't have random access into the data to display
-            // anymore, which is why we don't use the clipper. Storing or skimming through the search result would make
-            // it possible (and would be recommended if you want to search through tens of thousands of entries).
-            ImGuiListClipper clipper;
-            clipper.Begin(LineOffsets.Size);
-            while (clipper.Step()) {
-                for (int line_no = clipper.DisplayStart; line_no < clipper.DisplayEnd; line_no++) {
-                    const char* line_start = buf + LineOffsets[line_no];
-                    const char* line_end = (line_no + 1 < LineOffsets.Size) ? (buf + LineOffsets[line_no + 1] - 1) : buf_end;
-                    ImGui::TextUnformatted(line_start, line_end);
-                }
+
+        ImGui::PushStyleVar(ImGuiStyleVar_ItemSpacing, ImVec2(0, 0));
+
+        // The index gives random access to the filtered records, so the clipper
+        // only submits the rows within the visible area whatever the size of the log
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(_visible.size()));
+        while (clipper.Step()) {
+            for (int row = clipper.DisplayStart; row < clipper.DisplayEnd; row++) {
+                const auto& record = _records[_visible[row] % _records.size()];
+                ImGui::PushStyleColor(ImGuiCol_Text, levelColor(record.level));
+                ImGui::TextUnformatted(record.text.data(), record.text.data() + record.text.size());
+                ImGui::PopStyleColor();
             }
-            clipper.End();
         }
+        clipper.End();
+
         ImGui::PopStyleVar();
 
         // Keep up at the bottom of the scroll region if we were already at the bottom at the beginning of the frame.
@@ -90,8 +211,6 @@ void GuiDebugLog::render(GameWindow& gw) {
     ImGui::End();
 }
 
-
-
 void GuiAnimableStates::init() {
     tmp_pos_x = animable.getPosition().x;
     tmp_pos_y = animable.getPosition().y;
@@ -187,6 +306,164 @@ void GuiSpriteTest::render(GameWindow& gw) {
     ImGui::End();
 }
 
+void GuiLatency::render(GameWindow& gw) {
+    ImGui::SetNextWindowSize(ImVec2(560, 140), ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("Latency")) {
+        ImGui::End();
+        return;
+    }
+
+    if (ImGui::Button("Reset")) {
+        for (auto& series : _series)
+            series.histogram->reset();
+    }
+    ImGui::SameLine();
+    ImGui::TextDisabled("(ms, since the last reset)");
+
+    constexpr int COLUMNS = 8;
+    if (ImGui::BeginTable("latency", COLUMNS, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        for (const char* header : {"", "count", "mean", "p50", "p99", "p99.9", "max", "min"})
+            ImGui::TableSetupColumn(header);
+        ImGui::TableHeadersRow();
+
+        auto cell = [](std::chrono::nanoseconds value) {
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", std::chrono::duration<double, std::milli>(value).count());
+        };
+
+        for (const auto& series : _series) {
+            const LatencyHistogram& h = *series.histogram;
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(series.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(h.count()));
+            cell(h.mean());
+            cell(h.percentile(50.0));
+            cell(h.percentile(99.0));
+            cell(h.percentile(99.9));
+            cell(h.max());
+            cell(h.min());
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+void GuiPerformance::addSample(const PerformanceSample& sample) {
+    _frameMs.push(sample.frameMs);
+    _updateMs.push(sample.updateMs);
+    _renderMs.push(sample.renderMs);
+    _drawCalls.push(static_cast<float>(sample.drawCalls));
+    _allocations.push(static_cast<float>(sample.allocations));
+    _entities.push(static_cast<float>(sample.entities));
+}
+
+void GuiPerformance::plot(const char* label, const RingBuffer<float, HISTORY>& values, const char* unit, float minScale) {
+    if (values.empty())
+        return;
+
+    float maxValue = minScale;
+    for (size_t i = 0; i < values.size(); ++i)
+        maxValue = std::max(maxValue, values[i]);
+
+    char overlay[64];
+    std::snprintf(overlay, sizeof(overlay), "%.2f %s (max %.2f)", values.back(), unit, maxValue);
+    ImGui::PlotLines(label, values.data(), static_cast<int>(values.size()), static_cast<int>(values.offset()),
+        overlay, 0.0f, maxValue * 1.1f, ImVec2(0, 50));
+}
+
+void GuiPerformance::render(GameWindow& gw) {
+    ImGui::SetNextWindowSize(ImVec2(420, 520), ImGuiCond_FirstUseEver);
+
+    if (!ImGui::Begin("Performance")) {
+        ImGui::End();
+        return;
+    }
+
+    plot("Frame", _frameMs, "ms", 16.7f);
+    plot("Update", _updateMs, "ms", 1.0f);
+    plot("Render", _renderMs, "ms", 1.0f);
+
+    if (!_updateMs.empty()) {
+        const float total = _updateMs.back() + _renderMs.back();
+        const float updateShare = total > 0.0f ? _updateMs.back() / total : 0.0f;
+        ImGui::ProgressBar(updateShare, ImVec2(-1, 0), std::format("update {:.0f}% / render {:.0f}%", 
+            updateShare * 100.0f, (1.0f - updateShare) * 100.0f).c_str());
+    }
+
+    plot("Draw calls", _drawCalls, "", 1.0f);
+    plot("Allocations", _allocations, "/frame", 1.0f);
+    plot("Entities", _entities, "", 1.0f);
+
+    ImGui::Text("Textures: %zu", AssetManager::getInstance().getCountTextures());
+
+    if (ImGui::CollapsingHeader("Entities per tag", ImGuiTreeNodeFlags_DefaultOpen)) {
+        EntityManager::getInstance().forEachTag([](const std::string& tag, size_t count) {
+            ImGui::Text("%-16s %zu", tag.c_str(), count);
+        });
+    }
+
+    if (ImGui::CollapsingHeader("Hardware counters")) {
+        renderCounters();
+    }
+
+    ImGui::End();
+}
+
+void GuiPerformance::renderCounters() {
+    PerfCounters& counters = PerfCounters::getInstance();
+
+    bool enabled = counters.isEnabled();
+    if (ImGui::Checkbox("Sample perf events", &enabled))
+        counters.setEnabled(enabled);
+    if (!enabled)
+        return;
+
+    if (!counters.isAvailable()) {
+        ImGui::TextDisabled("%s", counters.getStatus().c_str());
+        return;
+    }
+
+    if (!ImGui::BeginTable("PerfCounters", 6, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+        return;
+
+    ImGui::TableSetupColumn("Zone");
+    ImGui::TableSetupColumn("Entities");
+    ImGui::TableSetupColumn("IPC");
+    ImGui::TableSetupColumn("L1D miss/e");
+    ImGui::TableSetupColumn("LLC miss/e");
+    ImGui::TableSetupColumn("Br miss/e");
+    ImGui::TableHeadersRow();
+
+    // Events the CPU does not count are shown as "-"
+    auto column = [](const PerfZoneStats& zone, PerfEvent event) {
+        ImGui::TableNextColumn();
+        if (zone.has(event))
+            ImGui::Text("%.2f", zone.perItem(event));
+        else
+            ImGui::TextDisabled("-");
+    };
+
+    for (const PerfZoneStats& zone : counters.getFrameStats()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(zone.name);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu", static_cast<unsigned long long>(zone.items));
+        ImGui::TableNextColumn();
+        if (zone.has(PerfEvent::Instructions))
+            ImGui::Text("%.2f", zone.ipc());
+        else
+            ImGui::TextDisabled("-");
+        column(zone, PerfEvent::L1DMisses);
+        column(zone, PerfEvent::LLCMisses);
+        column(zone, PerfEvent::BranchMisses);
+    }
+    ImGui::EndTable();
+}
 
 LoggerGui::LoggerGui(const LOG_LEVEL level, shared_ptr<GuiDebugLog>& p_guiDebugLog)
     : ILogger(level), guiDebugLog(p_guiDebugLog) {
@@ -197,5 +474,5 @@ LoggerGui::~LoggerGui() {}
 
 void LoggerGui::write(const LOG_LEVEL level, const std::string& s) {
 
-    guiDebugLog->addLog("%s\n", s.c_str());
+    guiDebugLog->addLog(level, s);
 }
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <string_view>
+#include <deque>
+#include <mutex>
 #include <fstream>
 #include <exception>
 #include <format>
@@ -15,6 +18,8 @@
 #include "sprite2d.h"
 #include "gamewindow.h"
 #include "animable.h"
+#include "latencyhistogram.h"
+#include "ringbuffer.h"
 
 namespace soul {
 
@@ -32,18 +37,40 @@ public:
 /**
  * @brief GuiDebugLog class
  * Window for logs displayed on screen using ImGui
+ * The logs are kept in a fixed-capacity ring of records: the oldest records are
+ * overwritten, and only the visible rows are rendered (ImGuiListClipper).
+ * addLog can be called from any thread, the records are moved into the ring by render.
  */
 class GuiDebugLog : public GuiWindow {
-private:
-    ImGuiTextBuffer     Buf;
-    ImGuiTextFilter     Filter;
-    ImVector<int>       LineOffsets; // Index to lines offset. We maintain this with AddLog() calls.
-    bool                AutoScroll;  // Keep scrolling if already at the bottom.
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 8192;
 
-    int                 RowCount {0};
+private:
+    struct LogRecord {
+        LOG_LEVEL   level {LOG_LEVEL::LOG_INFO};
+        std::string text;
+    };
+
+    // Ring of records, the record of sequence number n is at n % capacity
+    std::vector<LogRecord>  _records;
+    // Number of records ever added to the ring
+    uint64_t                _count {0};
+    // Sequence numbers of the records passing the filter, oldest first
+    std::deque<uint64_t>    _visible;
+
+    // Records added since the last render, protected by the mutex
+    std::mutex              _pendingMutex;
+    std::deque<LogRecord>   _pending;
+    std::deque<LogRecord>   _drained;
+
+    ImGuiTextFilter         Filter;
+    int                     MinLevel {0};
+    bool                    FilterDirty {false};
+    bool                    AutoScroll;  // Keep scrolling if already at the bottom.
 
 public:
-    GuiDebugLog() : GuiWindow() {
+    // A capacity of 0 is taken as 1, the ring is never empty
+    explicit GuiDebugLog(size_t capacity = DEFAULT_CAPACITY) : GuiWindow(), _records(std::max<size_t>(capacity, 1)) {
         AutoScroll = true;
         clear();
     }
@@ -52,22 +79,28 @@ public:
 
     void render(GameWindow& gw) override;
 
-    void clear() {
-        Buf.clear();
-        LineOffsets.clear();
-        LineOffsets.push_back(0);
-        RowCount = 0;
-    }
+    void clear();
+
+    void addLog(LOG_LEVEL level, std::string_view text);
+
+    void addLog(const char* fmt, ...) IM_FMTARGS(2);
+
+    size_t capacity() const { return _records.size(); }
+
+private:
+    // Move the pending records into the ring and index those passing the filter
+    void drainPending();
+
+    // Index again all the records of the ring, when the filter has changed
+    void rebuildIndex();
+
+    bool passFilter(const LogRecord& record) const;
 
-    void addLog(const char* fmt, ...) IM_FMTARGS(2) {
-        int old_size = Buf.size();
-        va_list args;
-        va_start(args, fmt);
-        Buf.appendfv(fmt, args);
-        va_end(args);
-        for (int new_size = Buf.size(); old_size < new_size; old_size++)
-            if (Buf[old_size] == '\n')
-                LineOffsets.push_back(old_size + 1);
+    // Options of the log categories registered in the LoggerManager
+    void renderCategories();
+
+    _ALWAYS_INLINE_ uint64_t oldest() const {
+        return _count > _records.size() ? _count - _records.size() : 0;
     }
 };
 
@@ -111,6 +144,76 @@ public:
     void render(GameWindow& gw) override;
 };
 
+/**
+ * @brief GuiLatency class
+ * Window for the tail latency of the game loop: percentiles of LatencyHistogram series
+ * (frame, update, render). The histograms are owned by the caller and recorded by the
+ * game loop thread, which also renders this window.
+ */
+class GuiLatency : public GuiWindow {
+private:
+    struct Series {
+        std::string       name;
+        LatencyHistogram* histogram;
+    };
+    std::vector<Series> _series;
+
+public:
+    GuiLatency() : GuiWindow() {}
+    virtual ~GuiLatency() {}
+
+    void addSeries(const std::string& name, LatencyHistogram& histogram) {
+        _series.push_back(Series{name, &histogram});
+    }
+
+    void render(GameWindow& gw) override;
+};
+
+/**
+ * @brief Measures of one frame for the Performance window
+ */
+struct PerformanceSample {
+    float frameMs {0.0f};
+    float updateMs {0.0f};
+    float renderMs {0.0f};
+    uint32_t drawCalls {0};
+    uint64_t allocations {0};
+    size_t entities {0};
+};
+
+/**
+ * @brief GuiPerformance class
+ * Window with rolling graphs of the last HISTORY frames: frame time, update/render split,
+ * draw calls, allocations and entities, plus the entities per tag and the textures loaded.
+ * The hardware counters section turns the perf events backend on and shows IPC and misses per entity.
+ * addSample only stores a few numbers in fixed-size rings, everything else (per tag counts,
+ * plots) is computed by render, which the game loop skips while the window is hidden.
+ */
+class GuiPerformance : public GuiWindow {
+public:
+    static constexpr size_t HISTORY = 240;
+
+private:
+    RingBuffer<float, HISTORY> _frameMs;
+    RingBuffer<float, HISTORY> _updateMs;
+    RingBuffer<float, HISTORY> _renderMs;
+    RingBuffer<float, HISTORY> _drawCalls;
+    RingBuffer<float, HISTORY> _allocations;
+    RingBuffer<float, HISTORY> _entities;
+
+public:
+    GuiPerformance() : GuiWindow() {}
+    virtual ~GuiPerformance() {}
+
+    void addSample(const PerformanceSample& sample);
+
+    void render(GameWindow& gw) override;
+
+private:
+    void plot(const char* label, const RingBuffer<float, HISTORY>& values, const char* unit, float minScale);
+    void renderCounters();
+};
+
 /**
  * @brief LoggerGui class
  * Logger for the GUI window
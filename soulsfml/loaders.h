@@ -4,6 +4,7 @@
 #include "canvas.h"
 #include "scene.h"
 #include "tile.h"
+#include "profiler.h"
 
 #include <iostream>
 #include <filesystem>
@@ -72,6 +73,7 @@ struct SceneLoader {
 template<>
 struct Loader<Player> {
     static std::unique_ptr<Player> load(std::string_view jsonPath) {
+        SOUL_PROFILE_SCOPE("Loader<Player>::load");
         LoggerManager& logManager = LoggerManager::getInstance();
 
         std::filesystem::path fullPath = jsonPath;
@@ -224,6 +226,7 @@ struct VectorLoader {
 template<>
 struct VectorLoader<Fireball> {
     static std::vector<std::shared_ptr<Fireball>> load(const std::string& jsonPath, const int itemCount, Player& player) {
+        SOUL_PROFILE_SCOPE("VectorLoader<Fireball>::load");
         LoggerManager& logManager = LoggerManager::getInstance();
         // PathManager& pathManager = PathManager::getInstance();
 
@@ -277,7 +280,8 @@ struct VectorLoader<Fireball> {
 
             logManager.log("Create Fireball {}", id);
 
-            auto inst = std::make_shared<Fireball>(
+            // Stored in the pool of the system, given back when the system drops it
+            auto inst = player.getFireballSystem().getPool().acquireShared(
                 player.getFireballSystem(),
                 "Fireball",
                 spriteData.initialPosition.x, 
@@ -328,6 +332,7 @@ struct VectorLoader<Fireball> {
 template<>
 struct Loader<Scene> {
     static std::unique_ptr<Scene> load(std::string_view jsonPath) {
+        SOUL_PROFILE_SCOPE("Loader<Scene>::load");
         LoggerManager& logManager = LoggerManager::getInstance();
 
         std::filesystem::path fullPath = jsonPath;
@@ -404,6 +409,7 @@ struct Loader<Scene> {
 template<>
 struct SceneLoader<Canvas> {
     static std::unique_ptr<Canvas> load(std::string_view jsonPath, Scene& scene) {
+        SOUL_PROFILE_SCOPE("SceneLoader<Canvas>::load");
         LoggerManager& logManager = LoggerManager::getInstance();
         PathManager& pathManager = PathManager::getInstance();
 
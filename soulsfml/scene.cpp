@@ -3,6 +3,7 @@
 #include "logger.h"
 #include "tile.h"
 #include "loaders.h"
+#include "perfcounters.h"
 
 #include <nlohmann/json.hpp>
 
@@ -16,24 +17,41 @@ Scene::Scene(const std::string& name) : _name(name) {
 
     const std::string canvasFile = pathManager.getFilePath(PathManager::FileType::Data, "canvas.json")->string();
     canvasLayer = SceneLoader<Canvas>::load(canvasFile, *this);
+
+    _buildFrameGraph();
+}
+
+void Scene::_buildFrameGraph() {
+    // Inputs, state machine and animation of the player, and its fireballs
+    frameGraph.addSystem("Player::update", 0, FrameGraph::resources<Player>(),
+        [this](float dt) { player->update(dt); });
+    // HUD, shows the health of the player
+    frameGraph.addSystem("Canvas::update", FrameGraph::resources<Player>(), FrameGraph::resources<Canvas>(),
+        [this](float dt) { canvasLayer->update(dt); });
+    // Entity updates in parallel, then their spawned and dead entities.
+    // Entities such as the fireballs follow the player, so they run after it as in the serial update
+    frameGraph.addSystem("EntityManager::update", 0, FrameGraph::resources<EntityManager, Player>(),
+        [this](float dt) {
+            entities.updateEntities(jobs, dt);
+            entities.update();
+        });
+
+    frameGraph.compile();
 }
 
 void Scene::update(float dt) {
-    // Hanlde Inputs in the Animable object
-    // Update the states and animation associated to the current movement or action
-    player->update(dt);
-    canvasLayer->update(dt);
+    SOUL_PROFILE_COUNTERS("Scene::update", entities.getTotalEntities());
 
-    entities.update();
+    // Independent systems run in parallel, see _buildFrameGraph()
+    frameGraph.run(jobs, dt);
 }
 
 void Scene::render() {
+    SOUL_PROFILE_SCOPE("Scene::render");
 
-    for (auto& entity : entities.getEntities()) {
-        if (entity->isActive()) {
-            entity->render();
-        }
-    }
+    // Only the renderable entities, without filtering
+    for (Entity* entity : renderables)
+        entity->render();
 
     player->render();
     canvasLayer->render();
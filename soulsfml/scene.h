@@ -8,6 +8,8 @@
 #include "assetmanager.h"
 #include "pathmanager.h"
 #include "vector2.h"
+#include "jobsystem.h"
+#include "framegraph.h"
 
 #include <memory>
 #include <vector>
@@ -36,12 +38,18 @@ public:
     GameWindow& gw = soul::GameWindow::getInstance();
     // Container for entities
     EntityManager&  entities = EntityManager::getInstance();
+    // Entities drawn by render(), kept up to date by the EntityManager
+    EntityView& renderables = entities.createView(EntityQuery {{}, ENTITY_RENDERABLE});
     // Container for Assets
     AssetManager&  assets = AssetManager::getInstance();
     // Always a Player in the Scene
     std::unique_ptr<Player> player;
     // Canvas 2D layer
     std::shared_ptr<Canvas> canvasLayer;
+    // Worker threads running the independent systems of the frame graph
+    JobSystem jobs;
+    // Systems of update() and the resources they read and write
+    FrameGraph frameGraph;
 
 public:
     /**
@@ -55,7 +63,7 @@ public:
      * @brief Destructor.
      *
      */
-    virtual ~Scene() {}
+    virtual ~Scene() { entities.removeView(renderables); }
 
     /**
      * @brief Update the scene in the game loop.
@@ -71,6 +79,12 @@ public:
     void render();
 
 private:
+    /**
+     * @brief Declares the systems of update() in their serial order.
+     *
+     */
+    void _buildFrameGraph();
+
     /**
      * @brief Handle collision between player and platform.
      *
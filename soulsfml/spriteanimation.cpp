@@ -1,5 +1,6 @@
 
 #include "spriteanimation.h"
+#include "perfcounters.h"
 
 using namespace soul;
 
@@ -89,6 +90,7 @@ void AnimationSet::addAnimation(AnimationState state, std::shared_ptr<SpriteAnim
 }
 
 void AnimationSet::update(float dt) {
+    SOUL_PROFILE_COUNTERS("AnimationSet::update", 1);
 
     if(_currentAnimation.first == AnimationState::None) return;
 
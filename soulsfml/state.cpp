@@ -4,6 +4,9 @@
 
 using namespace soul;
 
+// Log channel of the state machines, debug output enabled at runtime from the DebugLog window
+static const LogCategory s_logStates = LoggerManager::getInstance().registerCategory("States");
+
 /**
  * @brief Get Animation State from String
  */
@@ -127,7 +130,7 @@ void IdleState::update(Animable& a, float dt) {
 }
 
 void IdleState::enter(Animable& a) {
-    // logManager.logDebug("IdleState::enter");
+    logManager.log(s_logStates, LOG_LEVEL::LOG_DEBUG, "IdleState::enter {}", a.tag());
     a.setAnimationState(AnimationState::Idle); // Set idle animation
 }
 
@@ -171,7 +174,7 @@ void JumpState::update(Animable& a, float dt) {
 }
 
 void JumpState::enter(Animable& a) {
-    // logManager.logDebug("JumpState::enter");
+    logManager.log(s_logStates, LOG_LEVEL::LOG_DEBUG, "JumpState::enter {}", a.tag());
     a.setAnimationState(AnimationState::Jump); // Set jump animation
 }
 
@@ -199,7 +202,7 @@ void WalkState::update(Animable& a, float dt) {
 }
 
 void WalkState::enter(Animable& a) {
-    // logManager.logDebug("WalkState::enter");
+    logManager.log(s_logStates, LOG_LEVEL::LOG_DEBUG, "WalkState::enter {}", a.tag());
     a.setAnimationState(AnimationState::Walk); // Set walk animation
 }
 
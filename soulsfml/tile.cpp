@@ -60,5 +60,5 @@ bool Tile::update(float dt) {
 
 void Tile::render() {
     soul::GameWindow& gw = soul::GameWindow::getInstance();
-    gw.window.draw(_sprite->getSprite());
+    gw.draw(_sprite->getSprite());
 }
\ No newline at end of file
@@ -62,7 +62,9 @@ public:
 class Tile : public RigidBody {
 public:
     Tile() = delete;
-    explicit Tile(const std::string& p_tag, const sSpriteData& spriteData, bool isColliding = false) : RigidBody(p_tag, spriteData, isColliding) {}
+    explicit Tile(const std::string& p_tag, const sSpriteData& spriteData, bool isColliding = false) : RigidBody(p_tag, spriteData, isColliding) {
+        setFlags(ENTITY_RENDERABLE | (isColliding ? ENTITY_COLLIDER : 0));
+    }
     virtual ~Tile() = default;
 
     // Update the entity with specialized logic
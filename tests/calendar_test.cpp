@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "calendar.h"
+#include "datetime.h"
+#include <chrono>
+#include <ctime>
+#include <iostream>
+
+using namespace soul;
+
+// Every day from 1600 to 2400 against std::chrono
+TEST(CalendarTest, ExhaustiveConversions) {
+    const int32_t first = calendar::daysFromCivil(1600, 1, 1);
+    const int32_t last = calendar::daysFromCivil(2400, 12, 31);
+
+    calendar::CivilDate previous = calendar::civilFromDays(first - 1);
+    for (int32_t z = first; z <= last; ++z) {
+        const calendar::CivilDate date = calendar::civilFromDays(z);
+        const std::chrono::year_month_day ymd{calendar::toSysDays(z)};
+
+        ASSERT_EQ(date, calendar::fromYearMonthDay(ymd)) << z;
+        ASSERT_EQ(calendar::daysFromCivil(date), z);
+        ASSERT_EQ(calendar::weekdayFromDays(z), std::chrono::weekday{calendar::toSysDays(z)}.c_encoding());
+
+        // Consecutive days follow each other in the calendar
+        if (date.day == 1) {
+            ASSERT_EQ(previous.day, calendar::lastDayOfMonth(previous.year, previous.month));
+            ASSERT_EQ(date.month, previous.month % 12 + 1);
+        } else {
+            ASSERT_EQ(date.day, previous.day + 1);
+        }
+        previous = date;
+    }
+}
+
+// Month arithmetic against std::chrono with the same end of month clamping
+TEST(CalendarTest, AddMonthsMatchesChrono) {
+    const int32_t first = calendar::daysFromCivil(1700, 1, 1);
+    const int32_t last = calendar::daysFromCivil(2300, 12, 31);
+
+    for (int32_t z = first; z <= last; z += 3) {
+        const calendar::CivilDate date = calendar::civilFromDays(z);
+        for (int32_t months : {-1201, -25, -12, -1, 1, 2, 11, 12, 13, 600}) {
+            auto ymd = calendar::toYearMonthDay(date) + std::chrono::months{months};
+            if (!ymd.ok())
+                ymd = ymd.year() / ymd.month() / std::chrono::last;
+
+            ASSERT_EQ(calendar::addMonths(date, months), calendar::fromYearMonthDay(ymd));
+        }
+    }
+}
+
+TEST(CalendarTest, NegativeDaysAndLeapYears) {
+    EXPECT_TRUE(calendar::isLeapYear(2000));
+    EXPECT_FALSE(calendar::isLeapYear(1900));
+    EXPECT_TRUE(calendar::isLeapYear(-4));
+    EXPECT_EQ(calendar::lastDayOfMonth(2100, 2), 28u);
+    EXPECT_EQ(calendar::civilFromDays(calendar::daysFromCivil(-1, 12, 31)), (calendar::CivilDate{-1, 12, 31}));
+    EXPECT_EQ(calendar::endOfMonth(calendar::daysFromCivil(2024, 2, 3)), calendar::daysFromCivil(2024, 2, 29));
+}
+
+// Benchmark: pure arithmetic against the std::mktime/std::localtime implementation
+TEST(CalendarTest, BenchmarkAddMonths) {
+    constexpr int ITERATIONS = 200000;
+
+    // Previous implementation of DateTime::addMonths
+    auto legacyAddMonths = [](std::time_t time, int months) {
+        std::tm tm = {};
+        localtime_r(&time, &tm);
+        tm.tm_mon += months;
+        std::mktime(&tm);
+        return std::mktime(&tm);
+    };
+
+    std::time_t legacy = std::time(nullptr);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        legacy = legacyAddMonths(legacy, (i & 1) ? 1 : -1);
+    const std::chrono::duration<double> legacyTime = std::chrono::steady_clock::now() - start;
+
+    DateTime dt(2022, 1, 1);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ITERATIONS; ++i)
+        dt.addMonths((i & 1) ? 1 : -1);
+    const std::chrono::duration<double> pureTime = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(dt.year_month_day_h(), "2022-01-01");
+
+    std::cout << std::format("addMonths mktime/localtime: {:.0f} ops/s, calendar arithmetic: {:.0f} ops/s", 
+        ITERATIONS / legacyTime.count(), ITERATIONS / pureTime.count()) << std::endl;
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "date.h"
+#include "datetime.h"
+#include <chrono>
+#include <iostream>
+#include <numeric>
+#include <vector>
+
+using namespace soul;
+
+TEST(DateTest, CompactAndTriviallyCopyable) {
+    EXPECT_EQ(sizeof(Date), 4u);
+    EXPECT_TRUE(std::is_trivially_copyable_v<Date>);
+
+    constexpr Date date(2024, 2, 29);
+    static_assert(date.weekday() == 4);  // Thursday
+    static_assert(date.endOfMonth() == Date(2024, 2, 29));
+    static_assert(date.addYears(1) == Date(2025, 2, 28));
+    EXPECT_EQ(date + 1, Date(2024, 3, 1));
+    EXPECT_EQ(Date(2025, 1, 1) - date, 307);
+    EXPECT_LT(date, date + 1);
+}
+
+TEST(DateTest, ConversionWithDateTime) {
+    DateTime dt(2023, 7, 14);
+    dt.addSeconds(3600 * 15);
+
+    const Date date = Date::fromDateTime(dt);
+    EXPECT_EQ(date, Date(2023, 7, 14));
+    EXPECT_EQ(date.toDateTime().toString(), "2023-07-14 00:00:00");
+    EXPECT_EQ(date.toDateTime(), DateTime(2023, 7, 14));
+}
+
+// Batch operations against the scalar ones, over a range including negative serial days
+TEST(DateTest, BatchOperationsMatchScalar) {
+    const int32_t first = calendar::daysFromCivil(1600, 1, 1);
+    const int32_t last = calendar::daysFromCivil(2400, 12, 31);
+
+    std::vector<Date> column(static_cast<size_t>(last - first + 1));
+    for (size_t i = 0; i < column.size(); ++i)
+        column[i] = Date(first + static_cast<int32_t>(i));
+
+    std::vector<uint8_t> weekdays(column.size());
+    std::vector<Date> ends(column.size());
+    std::vector<int32_t> years(column.size());
+    std::vector<uint8_t> months(column.size());
+    std::vector<uint8_t> days(column.size());
+
+    dates::weekday(column, weekdays);
+    dates::endOfMonth(column, ends);
+    dates::toCivil(column, years, months, days);
+
+    for (size_t i = 0; i < column.size(); ++i) {
+        const calendar::CivilDate civil = column[i].civil();
+        ASSERT_EQ(weekdays[i], column[i].weekday());
+        ASSERT_EQ(ends[i], column[i].endOfMonth()) << column[i].days;
+        ASSERT_EQ(years[i], civil.year);
+        ASSERT_EQ(months[i], civil.month);
+        ASSERT_EQ(days[i], civil.day);
+    }
+
+    std::vector<int32_t> yearsOnly(column.size());
+    dates::yearMonth(column, yearsOnly, months);
+    EXPECT_EQ(yearsOnly, years);
+
+    dates::addDays(column, -7);
+    EXPECT_EQ(column.front(), Date(1599, 12, 25));
+
+    std::vector<uint8_t> tooSmall(3);
+    EXPECT_THROW(dates::weekday(column, tooSmall), std::invalid_argument);
+}
+
+// Benchmark: batch year/month extraction against DateTime
+TEST(DateTest, BenchmarkColumns) {
+    constexpr size_t COUNT = 2000000;
+    std::vector<Date> column(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        column[i] = Date(static_cast<int32_t>(i % 100000));
+    std::vector<int32_t> years(COUNT);
+    std::vector<uint8_t> months(COUNT);
+
+    auto start = std::chrono::steady_clock::now();
+    dates::yearMonth(column, years, months);
+    const std::chrono::duration<double> batch = std::chrono::steady_clock::now() - start;
+
+    std::vector<DateTime> dateTimes;
+    dateTimes.reserve(COUNT / 10);
+    for (size_t i = 0; i < COUNT / 10; ++i)
+        dateTimes.push_back(column[i].toDateTime());
+
+    int64_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (const DateTime& dt : dateTimes)
+        checksum += dt.civilDate().year;
+    const std::chrono::duration<double> scalar = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(checksum, std::accumulate(years.begin(), years.begin() + COUNT / 10, int64_t(0)));
+    std::cout << std::format("Year/month extraction: Date column {:.0f} rows/s ({} bytes/row), DateTime {:.0f} rows/s ({} bytes/row)",
+        COUNT / batch.count(), sizeof(Date), COUNT / 10 / scalar.count(), sizeof(DateTime)) << std::endl;
+}
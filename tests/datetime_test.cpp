@@ -2,6 +2,12 @@
 #include <gtest/gtest.h>
 #include "datetime.h"
 #include <iostream>
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
 
 using namespace soul;
 using namespace std;
@@ -66,13 +72,13 @@ TEST_F(DateTimeTest, SubtractDays) {
 // Test adding months to the DateTime object
 TEST_F(DateTimeTest, AddMonths) {
     dt.addMonths(3);  // Add 3 months
-    EXPECT_EQ(dt.toString(), "2022-04-01 01:00:00");
+    EXPECT_EQ(dt.toString(), "2022-04-01 00:00:00");
 }
 
 // Test subtracting months from the DateTime object
 TEST_F(DateTimeTest, SubtractMonths) {
     dt.subtractMonths(3);  // Subtract 3 months
-    EXPECT_EQ(dt.toString(), "2021-10-01 01:00:00");
+    EXPECT_EQ(dt.toString(), "2021-10-01 00:00:00");
 }
 
 // Test adding years to the DateTime object
@@ -109,3 +115,138 @@ TEST_F(DateTimeTest, SubtractBusinessDays) {
     EXPECT_EQ(dt.toString(), "2021-12-27 00:00:00");  // Before subtracting business days
 }
 
+// Test the month-end clamping of month and year arithmetic
+TEST_F(DateTimeTest, AddMonthsClampsToMonthEnd) {
+    DateTime jan31(2024, 1, 31);
+    jan31.addMonths(1);
+    EXPECT_EQ(jan31.year_month_day_h(), "2024-02-29");
+
+    DateTime leap(2024, 2, 29);
+    leap.addYears(1);
+    EXPECT_EQ(leap.year_month_day_h(), "2025-02-28");
+
+    DateTime mar31(2023, 3, 31);
+    mar31.subtractMonths(1);
+    EXPECT_EQ(mar31.year_month_day_h(), "2023-02-28");
+
+    // The time of the day is kept
+    dt.addSeconds(3661);
+    dt.addMonths(13);
+    EXPECT_EQ(dt.toString(), "2023-02-01 01:01:01");
+
+    EXPECT_THROW(DateTime(2023, 2, 29), std::invalid_argument);
+}
+
+// Test ISO-8601 parsing of dates and local timestamps
+TEST_F(DateTimeTest, ParseIso8601) {
+    EXPECT_EQ(DateTime::parse("2022-01-01"), dt);
+    EXPECT_EQ(DateTime::parse("2024-02-29T13:45:07").toString(), "2024-02-29 13:45:07");
+    EXPECT_EQ(DateTime::parse("2024-02-29 13:45").toString(), "2024-02-29 13:45:00");
+    EXPECT_EQ(DateTime::parse("1969-07-20T20:17:40.123456").toString(), "1969-07-20 20:17:40");
+
+    // Offsets: the same instant written in different zones
+    const DateTime utc = DateTime::parse("2023-06-15T12:00:00Z");
+    EXPECT_EQ(DateTime::parse("2023-06-15T14:30:00+02:30"), utc);
+    EXPECT_EQ(DateTime::parse("2023-06-15T07:00:00-0500"), utc);
+    EXPECT_EQ(DateTime::parse("2023-06-16T00:00:00+12"), utc);
+
+    // The fraction of second is kept
+    const DateTime fraction = DateTime::parse("2023-06-15T12:00:00.5Z");
+    DateTime later = utc;
+    later.addSeconds(1);
+    EXPECT_FALSE(fraction == utc);
+    EXPECT_EQ(DateTime::parse("2023-06-15T12:00:01.000000000001Z"), later);
+}
+
+TEST_F(DateTimeTest, ParseRejectsInvalidInput) {
+    for (const char* text : {"", "2022", "2022-1-01", "2022-13-01", "2023-02-29", "2022-01-01T", "2022-01-01X10:00",
+                             "2022-01-01T24:00", "2022-01-01T10:60", "2022-01-01T10:00:6", "2022-01-01T10:00:00.",
+                             "2022-01-01T10:00:00+1", "2022-01-01T10:00:00Z1", "2022-01-01T10:00:00+01:0", "2O22-01-01",
+                             "2022/01/01", "2022-01-01T10-00"}) {
+        EXPECT_FALSE(DateTime::tryParse(text).has_value()) << text;
+    }
+    EXPECT_THROW(DateTime::parse("2022-02-30"), std::invalid_argument);
+}
+
+TEST_F(DateTimeTest, FormatTo) {
+    dt.addSeconds(3600 * 13 + 60 * 5 + 9);
+
+    char buffer[DateTime::MAX_FORMAT_SIZE];
+    EXPECT_EQ(std::string_view(buffer, dt.formatTo(buffer)), "2022-01-01 13:05:09");
+    EXPECT_EQ(std::string_view(buffer, dt.formatIsoTo(buffer)), "2022-01-01T13:05:09");
+    EXPECT_EQ(std::string_view(buffer, dt.formatDateTo(buffer)), "2022-01-01");
+    EXPECT_EQ(std::string_view(buffer, dt.formatTimeTo(buffer)), "13:05:09");
+
+    // Round trip through the ISO writer
+    EXPECT_EQ(DateTime::parse(std::string_view(buffer, dt.formatIsoTo(buffer))), dt);
+}
+
+// Instants of both daylight saving periods are formatted with their own offset
+TEST_F(DateTimeTest, LocalTimeFollowsDaylightSaving) {
+    const char* previous = std::getenv("TZ");
+    const std::string saved = previous ? previous : "";
+    // Central European Time, rules given inline so that no tz database is needed
+    setenv("TZ", "CET-1CEST,M3.5.0,M10.5.0/3", 1);
+    tzset();
+
+    // The offsets are cached per thread: a new thread starts with the new TZ
+    std::thread([]() {
+        EXPECT_EQ(DateTime::parse("2024-01-15T12:00:00Z").toString(), "2024-01-15 13:00:00");
+        EXPECT_EQ(DateTime::parse("2024-07-15T12:00:00Z").toString(), "2024-07-15 14:00:00");
+
+        // Both sides of the change of the 31st of March, at 01:00 UTC
+        EXPECT_EQ(DateTime::parse("2024-03-31T00:30:00Z").timeToString(), "01:30:00");
+        EXPECT_EQ(DateTime::parse("2024-03-31T01:30:00Z").timeToString(), "03:30:00");
+
+        // Local times are converted back with the offset of their day
+        EXPECT_EQ(DateTime::parse("2024-01-15T13:00:00"), DateTime::parse("2024-01-15T12:00:00Z"));
+        EXPECT_EQ(DateTime::parse("2024-07-15T14:00:00"), DateTime::parse("2024-07-15T12:00:00Z"));
+        EXPECT_EQ(DateTime(2024, 7, 15).toString(), "2024-07-15 00:00:00");
+    }).join();
+
+    if (previous)
+        setenv("TZ", saved.c_str(), 1);
+    else
+        unsetenv("TZ");
+    tzset();
+}
+
+TEST_F(DateTimeTest, ParseBatch) {
+    const std::vector<std::string_view> texts = {"2022-01-01", "not a date", "2022-01-01T00:00:00", "2022-02-29"};
+    std::vector<DateTime> results(texts.size());
+    bool valid[4] = {};
+
+    EXPECT_EQ(DateTime::parseBatch(texts, results, valid), 2u);
+    EXPECT_TRUE(valid[0]);
+    EXPECT_FALSE(valid[1]);
+    EXPECT_TRUE(valid[2]);
+    EXPECT_FALSE(valid[3]);
+    EXPECT_EQ(results[0], dt);
+    EXPECT_EQ(results[2], dt);
+}
+
+// Benchmark: parsing timestamps as loaded from a data file
+TEST_F(DateTimeTest, BenchmarkParse) {
+    constexpr size_t COUNT = 1000000;
+    std::vector<std::string> storage;
+    storage.reserve(1000);
+    for (int i = 0; i < 1000; ++i) {
+        DateTime date(2000 + i % 30, 1 + i % 12, 1 + i % 28);
+        date.addSeconds(i * 37);
+        char buffer[DateTime::MAX_FORMAT_SIZE];
+        storage.emplace_back(buffer, date.formatIsoTo(buffer));
+    }
+    std::vector<std::string_view> texts(COUNT);
+    for (size_t i = 0; i < COUNT; ++i)
+        texts[i] = storage[i % storage.size()];
+
+    std::vector<DateTime> results(COUNT);
+    std::unique_ptr<bool[]> valid(new bool[COUNT]);
+    const auto start = std::chrono::steady_clock::now();
+    const size_t parsed = DateTime::parseBatch(texts, results, std::span<bool>(valid.get(), COUNT));
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(parsed, COUNT);
+    cout << std::format("ISO-8601 timestamps parsed: {:.0f} per second", COUNT / elapsed.count()) << endl;
+}
+
@@ -0,0 +1,442 @@
+#include <gtest/gtest.h>
+#include "entitymanager.h"
+#include "time_elapsed.h"
+#include <format>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <tuple>
+#include <unordered_set>
+#include <vector>
+
+using namespace soul;
+
+class EntityManagerTest : public ::testing::Test {
+protected:
+    void SetUp() override { manager.clear(); }
+    void TearDown() override { manager.clear(); }
+
+    std::shared_ptr<Entity> spawn(const std::string& tag) {
+        std::shared_ptr<Entity> e = std::make_shared<Entity>(tag);
+        manager.addEntity(e);
+        return e;
+    }
+
+    EntityManager& manager = EntityManager::getInstance();
+};
+
+TEST_F(EntityManagerTest, HandlesAreGivenOnUpdate) {
+    std::shared_ptr<Entity> a = spawn("tile");
+    EXPECT_FALSE(a->handle().isValid());
+
+    manager.update();
+    ASSERT_TRUE(a->handle().isValid());
+    EXPECT_EQ(manager.get(a->handle()), a.get());
+    EXPECT_EQ(manager.get(EntityHandle{}), nullptr);
+}
+
+TEST_F(EntityManagerTest, StaleHandlesAreDetected) {
+    std::shared_ptr<Entity> a = spawn("fireball");
+    manager.update();
+    const EntityHandle handle = a->handle();
+
+    a->setActive(false);
+    manager.update();
+    EXPECT_EQ(manager.get(handle), nullptr);
+    EXPECT_FALSE(a->handle().isValid());
+
+    // The slot is reused with the next generation
+    std::shared_ptr<Entity> b = spawn("fireball");
+    manager.update();
+    EXPECT_EQ(b->handle().index, handle.index);
+    EXPECT_NE(b->handle().generation, handle.generation);
+    EXPECT_EQ(manager.get(handle), nullptr);
+    EXPECT_EQ(manager.get(b->handle()), b.get());
+}
+
+TEST_F(EntityManagerTest, IdsAreUnique) {
+    constexpr int COUNT = 100000;
+    std::unordered_set<uint32_t> ids;
+    std::vector<std::shared_ptr<Entity>> entities;
+    entities.reserve(COUNT);
+
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int i = 0; i < COUNT; ++i)
+        entities.push_back(spawn("bullet"));
+    manager.update();
+    const double ms = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count();
+
+    for (const auto& e : entities) {
+        EXPECT_NE(e->ID(), 0u);
+        ids.insert(e->ID());
+        EXPECT_EQ(manager.get(e->handle()), e.get());
+    }
+    EXPECT_EQ(ids.size(), static_cast<size_t>(COUNT));
+    std::cout << std::format("{} entities created and committed in {:.2f} ms\n", COUNT, ms);
+}
+
+TEST_F(EntityManagerTest, EntitiesAreListedPerTag) {
+    const TagId tile = TagInterner::getInstance().intern("tile");
+    std::shared_ptr<Entity> a = spawn("tile");
+    std::shared_ptr<Entity> b = std::make_shared<Entity>(tile);
+    manager.addEntity(b);
+    spawn("enemy");
+    manager.update();
+
+    EXPECT_EQ(a->tagId(), tile);
+    EXPECT_EQ(b->tag(), "tile");
+    EXPECT_EQ(manager.getEntities(tile).size(), 2u);
+    EXPECT_EQ(manager.getEntities("enemy").size(), 1u);
+    EXPECT_TRUE(manager.getEntities("unknown").empty());
+
+    a->setActive(false);
+    manager.update();
+    ASSERT_EQ(manager.getEntities(tile).size(), 1u);
+    EXPECT_EQ(manager.getEntities(tile)[0], b);
+
+    size_t tags = 0;
+    manager.forEachTag([&tags](const std::string& tag, size_t count) {
+        EXPECT_TRUE(tag == "tile" || tag == "enemy");
+        EXPECT_EQ(count, 1u);
+        ++tags;
+    });
+    EXPECT_EQ(tags, 2u);
+}
+
+TEST_F(EntityManagerTest, KillListRemovesOnlyTheDead) {
+    std::vector<std::shared_ptr<Entity>> entities;
+    for (int i = 0; i < 1000; ++i)
+        entities.push_back(spawn(i % 3 ? "enemy" : "tile"));
+    manager.update();
+
+    // Every 7th dies, one of them is revived before the update
+    for (size_t i = 0; i < entities.size(); i += 7)
+        entities[i]->setActive(false);
+    entities[7]->setActive(true);
+    manager.update();
+
+    size_t alive = 0;
+    for (size_t i = 0; i < entities.size(); ++i) {
+        const bool dead = i % 7 == 0 && i != 7;
+        EXPECT_EQ(manager.isAlive(entities[i]->handle()), !dead);
+        alive += !dead;
+    }
+    EXPECT_EQ(manager.getTotalEntities(), alive);
+    EXPECT_EQ(manager.getEntities("enemy").size() + manager.getEntities("tile").size(), alive);
+
+    // Every list only holds active entities, each at the position it knows by its handle
+    for (const auto& e : manager.getEntities())
+        EXPECT_EQ(manager.get(e->handle()), e.get());
+
+    // A second kill of a removed entity is ignored
+    entities[0]->setActive(true);
+    entities[0]->setActive(false);
+    manager.update();
+    EXPECT_EQ(manager.getTotalEntities(), alive);
+}
+
+TEST_F(EntityManagerTest, BenchmarkChurn) {
+    constexpr int COUNT = 100000;
+    constexpr int FRAMES = 100;
+    constexpr int CHURN = COUNT / 100;
+    const TagId tags[] = {
+        TagInterner::getInstance().intern("tile"),
+        TagInterner::getInstance().intern("enemy"),
+        TagInterner::getInstance().intern("fireball")};
+
+    std::vector<std::shared_ptr<Entity>> entities;
+    for (int i = 0; i < COUNT; ++i) {
+        entities.push_back(std::make_shared<Entity>(tags[i % 3]));
+        manager.addEntity(entities.back());
+    }
+    manager.update();
+
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame)
+        manager.update();
+    const double idleUs = std::chrono::duration<double, std::micro>(elapsed.elapsed()).count() / FRAMES;
+
+    // 1% of the entities die and are replaced every frame
+    uint32_t seed = 12345;
+    std::chrono::nanoseconds updates {0};
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        for (int i = 0; i < CHURN; ++i) {
+            seed = seed * 1664525u + 1013904223u;
+            const size_t victim = seed % entities.size();
+            entities[victim]->setActive(false);
+            entities[victim] = std::make_shared<Entity>(tags[victim % 3]);
+            manager.addEntity(entities[victim]);
+        }
+        elapsed.start();
+        manager.update();
+        updates += elapsed.elapsed();
+    }
+    const double churnUs = std::chrono::duration<double, std::micro>(updates).count() / FRAMES;
+
+    EXPECT_EQ(manager.getTotalEntities(), static_cast<size_t>(COUNT));
+    for (const auto& e : entities)
+        EXPECT_TRUE(manager.isAlive(e->handle()));
+    std::cout << std::format("{} entities, {} deaths per frame: update {:.1f} us, idle update {:.2f} us\n",
+        COUNT, CHURN, churnUs, idleUs);
+}
+
+TEST_F(EntityManagerTest, SpawnFromWorkerThreads) {
+    constexpr int THREADS = 4;
+    constexpr int SPAWNS = 5000;
+    const TagId tag = TagInterner::getInstance().intern("fireball");
+
+    std::atomic<int> done {0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([this, tag, &done]() {
+            for (int i = 0; i < SPAWNS; ++i)
+                manager.addEntity(std::make_shared<Entity>(tag));
+            done.fetch_add(1);
+        });
+    }
+
+    // The game thread keeps updating while the workers spawn
+    while (done.load() < THREADS)
+        manager.update();
+    for (auto& worker : workers)
+        worker.join();
+    manager.update();
+
+    EXPECT_EQ(manager.getTotalEntities(), static_cast<size_t>(THREADS * SPAWNS));
+    const auto& fireballs = manager.getEntities(tag);
+    ASSERT_EQ(fireballs.size(), static_cast<size_t>(THREADS * SPAWNS));
+    for (const auto& e : fireballs)
+        EXPECT_EQ(manager.get(e->handle()), e.get());
+}
+
+namespace {
+
+// Behaves from its own state only: now and then dies, spawns, kills its parent or changes tag
+class ReplayedEntity : public Entity {
+public:
+    ReplayedEntity(TagId tag, uint32_t seed, EntityHandle parent = {}) : Entity(tag), seed(seed), parent(parent) {}
+
+    bool update(float dt) override {
+        EntityManager& manager = EntityManager::getInstance();
+        seed = seed * 1664525u + 1013904223u;
+        distance += dt * static_cast<float>(seed >> 20);
+
+        switch (seed >> 27) {
+            case 0: return false;
+            case 1: manager.addEntity(std::make_shared<ReplayedEntity>(tagId(), seed ^ 0x9e3779b9u, handle())); break;
+            case 2: manager.kill(parent); break;
+            case 3: manager.setTag(*this, TagInterner::getInstance().intern(seed & 1 ? "enemy" : "tile")); break;
+            default: break;
+        }
+        return isActive();
+    }
+
+    uint32_t seed;
+    EntityHandle parent;
+    float distance {0.0f};
+};
+
+// Order and state of every list
+std::vector<std::tuple<uint32_t, TagId, float>> snapshot(EntityManager& manager) {
+    std::vector<std::tuple<uint32_t, TagId, float>> state;
+    auto add = [&state](const std::vector<std::shared_ptr<Entity>>& entities) {
+        for (const auto& e : entities) {
+            const auto& replayed = static_cast<const ReplayedEntity&>(*e);
+            state.emplace_back(replayed.seed, replayed.tagId(), replayed.distance);
+        }
+    };
+    add(manager.getEntities());
+    add(manager.getEntities("tile"));
+    add(manager.getEntities("enemy"));
+    return state;
+}
+
+} // namespace
+
+TEST_F(EntityManagerTest, CommandsOfTheUpdateAreApplied) {
+    const TagId tile = TagInterner::getInstance().intern("tile");
+    const TagId enemy = TagInterner::getInstance().intern("enemy");
+    auto parent = std::make_shared<ReplayedEntity>(tile, 0);
+    manager.addEntity(parent);
+    manager.update();
+
+    // The seed of the next update spawns a child
+    auto step = [&](uint32_t seed) {
+        parent->seed = seed;
+        manager.updateEntities(0.016f);
+        manager.update();
+    };
+    uint32_t spawnSeed = 0;
+    while (((spawnSeed * 1664525u + 1013904223u) >> 27) != 1)
+        ++spawnSeed;
+    step(spawnSeed);
+    ASSERT_EQ(manager.getTotalEntities(), 2u);
+    auto child = std::static_pointer_cast<ReplayedEntity>(manager.getEntities()[1]);
+    EXPECT_EQ(child->parent, parent->handle());
+
+    manager.setTag(*child, enemy);
+    EXPECT_EQ(manager.getEntities(tile).size(), 1u);
+    ASSERT_EQ(manager.getEntities(enemy).size(), 1u);
+    EXPECT_EQ(manager.getEntities(enemy)[0], child);
+    EXPECT_EQ(child->tag(), "enemy");
+
+    manager.kill(parent->handle());
+    manager.update();
+    EXPECT_FALSE(manager.isAlive(parent->handle()));
+    EXPECT_EQ(manager.getTotalEntities(), 1u);
+}
+
+TEST_F(EntityManagerTest, ParallelUpdateMatchesSerialUpdate) {
+    constexpr int COUNT = 20000;
+    constexpr int FRAMES = 30;
+    const TagId tags[] = {TagInterner::getInstance().intern("tile"), TagInterner::getInstance().intern("enemy")};
+
+    auto populate = [&]() {
+        manager.clear();
+        for (uint32_t i = 0; i < COUNT; ++i)
+            manager.addEntity(std::make_shared<ReplayedEntity>(tags[i % 2], i));
+        manager.update();
+    };
+
+    populate();
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        manager.updateEntities(0.016f);
+        manager.update();
+    }
+    const double serialMs = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count() / FRAMES;
+    const auto serial = snapshot(manager);
+
+    JobSystem jobs(3);
+    populate();
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        manager.updateEntities(jobs, 0.016f);
+        manager.update();
+    }
+    const double parallelMs = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count() / FRAMES;
+    const auto parallel = snapshot(manager);
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    EXPECT_TRUE(serial == parallel);
+    for (const auto& e : manager.getEntities())
+        EXPECT_EQ(manager.get(e->handle()), e.get());
+    std::cout << std::format("{} entities after {} frames: serial update {:.2f} ms, parallel update {:.2f} ms ({} workers)\n",
+        manager.getTotalEntities(), FRAMES, serialMs, parallelMs, jobs.getCountWorkers());
+}
+
+namespace {
+
+class FlaggedEntity : public Entity {
+public:
+    FlaggedEntity(const std::string& tag, EntityFlags flags) : Entity(tag) { setFlags(flags); }
+};
+
+// The view holds exactly the entities of the manager matching it
+void expectViewMatches(EntityManager& manager, const EntityView& view) {
+    std::unordered_set<const Entity*> listed(view.begin(), view.end());
+    EXPECT_EQ(listed.size(), view.size());
+    size_t matching = 0;
+    for (const auto& e : manager.getEntities()) {
+        EXPECT_EQ(listed.count(e.get()) == 1, view.matches(*e)) << e->tag();
+        matching += view.matches(*e);
+    }
+    EXPECT_EQ(matching, view.size());
+}
+
+} // namespace
+
+TEST_F(EntityManagerTest, ViewsFollowTheEntities) {
+    const TagId tile = TagInterner::getInstance().intern("tile");
+    const TagId enemy = TagInterner::getInstance().intern("enemy");
+
+    std::vector<std::shared_ptr<Entity>> entities;
+    for (int i = 0; i < 300; ++i) {
+        entities.push_back(std::make_shared<FlaggedEntity>(i % 3 ? "tile" : "enemy", i % 2 ? ENTITY_COLLIDER : ENTITY_RENDERABLE));
+        manager.addEntity(entities.back());
+    }
+    manager.update();
+
+    // Created after the entities, filled with them
+    EntityView& tileColliders = manager.createView(EntityQuery {{tile}, ENTITY_COLLIDER});
+    EntityView& renderables = manager.createView(EntityQuery {{}, ENTITY_RENDERABLE});
+    EXPECT_EQ(tileColliders.size(), 100u);
+    EXPECT_EQ(renderables.size(), 150u);
+    expectViewMatches(manager, tileColliders);
+
+    // Committed entities join
+    for (int i = 0; i < 50; ++i) {
+        entities.push_back(std::make_shared<FlaggedEntity>("tile", ENTITY_COLLIDER | ENTITY_RENDERABLE));
+        manager.addEntity(entities.back());
+    }
+    manager.update();
+    EXPECT_EQ(tileColliders.size(), 150u);
+    EXPECT_EQ(renderables.size(), 200u);
+
+    // Dead entities leave at the update
+    for (size_t i = 0; i < entities.size(); i += 5)
+        entities[i]->setActive(false);
+    manager.update();
+    expectViewMatches(manager, tileColliders);
+    expectViewMatches(manager, renderables);
+    for (const Entity* e : renderables)
+        EXPECT_TRUE(e->isActive());
+
+    // Tag and flag changes move entities in and out
+    for (size_t i = 1; i < entities.size(); i += 5) {
+        manager.setTag(*entities[i], entities[i]->tagId() == tile ? enemy : tile);
+        manager.setFlags(*entities[i], entities[i]->flags() ^ ENTITY_COLLIDER);
+    }
+    expectViewMatches(manager, tileColliders);
+    expectViewMatches(manager, renderables);
+
+    manager.clear();
+    EXPECT_TRUE(tileColliders.empty());
+    EXPECT_TRUE(renderables.empty());
+    manager.removeView(tileColliders);
+    manager.removeView(renderables);
+}
+
+TEST_F(EntityManagerTest, BenchmarkViewIteration) {
+    constexpr int COUNT = 100000;
+    constexpr int FRAMES = 100;
+    const TagId tile = TagInterner::getInstance().intern("tile");
+
+    for (int i = 0; i < COUNT; ++i)
+        manager.addEntity(std::make_shared<FlaggedEntity>(i % 3 ? "tile" : "enemy", i % 2 ? ENTITY_COLLIDER : 0));
+    manager.update();
+    // A few dead ones not removed yet, as between two updates
+    for (size_t i = 0; i < manager.getEntities().size(); i += 97)
+        manager.getEntities()[i]->setActive(false);
+
+    EntityView& colliders = manager.createView(EntityQuery {{tile}, ENTITY_COLLIDER});
+
+    uint64_t filteredSum = 0;
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        for (const auto& e : manager.getEntities(tile)) {
+            if (e->isActive() && e->hasFlags(ENTITY_COLLIDER))
+                filteredSum += e->ID();
+        }
+    }
+    const double filteredUs = std::chrono::duration<double, std::micro>(elapsed.elapsed()).count() / FRAMES;
+
+    // The update removes the dead, the view is what the filter selects
+    manager.update();
+    uint64_t viewSum = 0;
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        for (const Entity* e : colliders)
+            viewSum += e->ID();
+    }
+    const double viewUs = std::chrono::duration<double, std::micro>(elapsed.elapsed()).count() / FRAMES;
+
+    EXPECT_EQ(filteredSum, viewSum);
+    std::cout << std::format("{} tile colliders of {} entities: filtered loop {:.1f} us, view {:.1f} us\n",
+        colliders.size(), manager.getTotalEntities(), filteredUs, viewUs);
+    manager.removeView(colliders);
+}
@@ -32,4 +32,29 @@ TEST_F(FireballTest, FireballSystemInit) {
     }
     EXPECT_FALSE(fireballSystem.getFireballs().empty());
     EXPECT_EQ(fireballSystem.getFireballs().size(), fireballSystem.getFireballCount());
-}
\ No newline at end of file
+}
+
+TEST_F(FireballTest, FireballsLiveInThePool) {
+    try {
+        fireballSystem.initFireballs(player.get(), filePath, 300.0, 2.0);
+        // Loading again gives the blocks back first, the pool never grows
+        fireballSystem.initFireballs(player.get(), filePath, 300.0, 2.0);
+    } catch (const std::runtime_error& e) {
+        FAIL() << "Failed to initialize fireballs: " << e.what();
+    }
+    const ObjectPoolStats& stats = fireballSystem.getPoolStats();
+    EXPECT_EQ(stats.live, static_cast<size_t>(fireballSystem.getFireballCount()));
+    EXPECT_EQ(stats.capacity, static_cast<size_t>(fireballSystem.getFireballCount()));
+    EXPECT_EQ(stats.slabs, 1u);
+}
+
+TEST_F(FireballTest, ResetThreadsAreStartedOnce) {
+    try {
+        fireballSystem.initFireballs(player.get(), filePath, 300.0, 2.0);
+        fireballSystem.initFireballs(player.get(), filePath, 300.0, 2.0);
+    } catch (const std::runtime_error& e) {
+        FAIL() << "Failed to initialize fireballs: " << e.what();
+    }
+    // Shots wake the same threads, none is created per shot
+    EXPECT_EQ(fireballSystem.getResetThreadCount(), static_cast<size_t>(fireballSystem.getFireballCount()));
+}
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "framegraph.h"
+#include "systems.h"
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace soul;
+using namespace soul::ecs;
+
+namespace {
+
+// Resources outside the ECS
+struct Input {};
+struct Hud {};
+
+std::vector<FrameGraph::NodeId> dependenciesOf(const FrameGraph& graph, FrameGraph::NodeId id) {
+    return graph.node(id).dependencies;
+}
+
+} // namespace
+
+TEST(FrameGraphTest, ResourcesHaveStableIdsAndNames) {
+    EXPECT_EQ(FrameGraph::resourceId<Transform>(), FrameGraph::resourceId<Transform>());
+    EXPECT_NE(FrameGraph::resourceId<Transform>(), FrameGraph::resourceId<Velocity>());
+    EXPECT_EQ((FrameGraph::resources<Transform, Velocity>()),
+        (ResourceMask(1) << FrameGraph::resourceId<Transform>()) | (ResourceMask(1) << FrameGraph::resourceId<Velocity>()));
+    EXPECT_EQ(FrameGraph::resourceName(FrameGraph::resourceId<Transform>()), "soul::ecs::Transform");
+    EXPECT_THROW(FrameGraph::resourceName(FrameGraph::MAX_RESOURCES), std::out_of_range);
+}
+
+TEST(FrameGraphTest, EdgesFollowConflicts) {
+    FrameGraph graph;
+    const auto input = graph.addSystem("input", 0, FrameGraph::resources<Input>(), [](float) {});
+    const auto integrate = graph.addSystem("integrate", FrameGraph::resources<Velocity, Input>(), FrameGraph::resources<Transform>(), [](float) {});
+    const auto animate = graph.addSystem("animate", 0, FrameGraph::resources<Animation, Sprite>(), [](float) {});
+    const auto hud = graph.addSystem("hud", FrameGraph::resources<Transform>(), FrameGraph::resources<Hud>(), [](float) {});
+    const auto render = graph.addSystem("render", FrameGraph::resources<Transform, Sprite>(), 0, [](float) {});
+    const auto expire = graph.addSystem("expire", 0, FrameGraph::resources<Transform, Lifetime>(), [](float) {});
+    graph.compile();
+
+    // Read after write
+    EXPECT_EQ(dependenciesOf(graph, integrate), std::vector<FrameGraph::NodeId> {input});
+    // Independent of the others
+    EXPECT_TRUE(dependenciesOf(graph, animate).empty());
+    EXPECT_EQ(dependenciesOf(graph, hud), std::vector<FrameGraph::NodeId> {integrate});
+    // Two readers of Transform do not depend on each other
+    EXPECT_EQ(dependenciesOf(graph, render), (std::vector<FrameGraph::NodeId> {integrate, animate}));
+    // Write after read of both readers, the write after write on integrate is implied by them
+    EXPECT_EQ(dependenciesOf(graph, expire), (std::vector<FrameGraph::NodeId> {hud, render}));
+    EXPECT_EQ(graph.node(integrate).dependents, (std::vector<FrameGraph::NodeId> {hud, render}));
+}
+
+TEST(FrameGraphTest, RunRespectsDependencies) {
+    constexpr int NODES = 64;
+    FrameGraph graph;
+    std::atomic<int> clock {0};
+    std::vector<int> finished(NODES, -1);
+
+    // Chains and fans over a few resources
+    struct R0 {}; struct R1 {}; struct R2 {}; struct R3 {};
+    const ResourceMask resources[] = {FrameGraph::resources<R0>(), FrameGraph::resources<R1>(),
+        FrameGraph::resources<R2>(), FrameGraph::resources<R3>()};
+    for (int i = 0; i < NODES; ++i) {
+        const ResourceMask reads = resources[i % 4] | resources[(i / 4) % 4];
+        const ResourceMask writes = (i % 3 == 0) ? resources[(i + 1) % 4] : 0;
+        graph.addSystem(std::format("node {}", i), reads, writes, [&finished, &clock, i](float) {
+            std::this_thread::sleep_for(std::chrono::microseconds(i % 5 * 20));
+            finished[i] = clock.fetch_add(1);
+        });
+    }
+
+    JobSystem jobs(3);
+    for (int frame = 0; frame < 20; ++frame) {
+        clock = 0;
+        std::fill(finished.begin(), finished.end(), -1);
+        graph.run(jobs, 0.016f);
+
+        for (FrameGraph::NodeId i = 0; i < NODES; ++i) {
+            ASSERT_GE(finished[i], 0) << graph.node(i).name;
+            for (const FrameGraph::NodeId dependency : graph.node(i).dependencies)
+                ASSERT_LT(finished[dependency], finished[i]) << graph.node(i).name;
+        }
+    }
+}
+
+TEST(FrameGraphTest, IndependentSystemsRunInParallel) {
+    FrameGraph graph;
+    std::atomic<int> arrived {0};
+    std::atomic<bool> overlapped {true};
+
+    // Each waits for the other, only possible when they run at the same time
+    auto meet = [&](float) {
+        arrived.fetch_add(1);
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (arrived.load() < 2) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                overlapped = false;
+                return;
+            }
+            std::this_thread::yield();
+        }
+    };
+    graph.addSystem("left", FrameGraph::resources<Transform>(), FrameGraph::resources<Velocity>(), meet);
+    graph.addSystem("right", FrameGraph::resources<Transform>(), FrameGraph::resources<Animation>(), meet);
+
+    JobSystem jobs(2);
+    graph.run(jobs, 0.016f);
+    EXPECT_TRUE(overlapped);
+    EXPECT_EQ(arrived, 2);
+}
+
+TEST(FrameGraphTest, ErrorsSkipDependentsAndAreRethrown) {
+    FrameGraph graph;
+    bool dependentRan = false;
+    bool independentRan = false;
+    graph.addSystem("throws", 0, FrameGraph::resources<Transform>(), [](float) { throw std::runtime_error("system failed"); });
+    graph.addSystem("dependent", FrameGraph::resources<Transform>(), 0, [&](float) { dependentRan = true; });
+    graph.addSystem("independent", 0, FrameGraph::resources<Lifetime>(), [&](float) { independentRan = true; });
+
+    JobSystem jobs(2);
+    EXPECT_THROW(graph.run(jobs, 0.016f), std::runtime_error);
+    EXPECT_FALSE(dependentRan);
+    EXPECT_TRUE(independentRan);
+}
+
+TEST(FrameGraphTest, EcsSystemsMatchSerialUpdate) {
+    auto populate = [](World& world) {
+        for (int i = 0; i < 5000; ++i) {
+            const float f = static_cast<float>(i);
+            world.create(Transform {f, -f}, Velocity {1.0f + f * 0.01f, 2.0f},
+                Sprite {0, 0.0f, 0.0f, 16.0f, 16.0f}, Animation {0.0f, 0.05f, 0.0f, 0, 8}, Lifetime {0.1f + f * 0.0001f});
+        }
+    };
+    World serial, parallel;
+    populate(serial);
+    populate(parallel);
+
+    FrameGraph graph;
+    graph.addSystem("ecs::integrate", FrameGraph::resources<Velocity>(), FrameGraph::resources<Transform>(),
+        [&parallel](float dt) { integrate(parallel, dt); });
+    graph.addSystem("ecs::animate", 0, FrameGraph::resources<Animation, Sprite>(),
+        [&parallel](float dt) { animate(parallel, dt); });
+    graph.addSystem("ecs::expire", 0, FrameGraph::resources<Lifetime>(),
+        [&parallel](float dt) { expire(parallel, dt); });
+    // Structural change, after every system
+    graph.addSystem("World::flush", 0, FrameGraph::resources<Transform, Velocity, Sprite, Animation, Lifetime>(),
+        [&parallel](float) { parallel.flush(); });
+
+    JobSystem jobs(3);
+    for (int frame = 0; frame < 10; ++frame) {
+        update(serial, 0.016f);
+        graph.run(jobs, 0.016f);
+    }
+
+    ASSERT_EQ(serial.size(), parallel.size());
+    std::vector<Transform> expected, actual;
+    serial.each<Transform>([&expected](const Transform& t) { expected.push_back(t); });
+    parallel.each<Transform>([&actual](const Transform& t) { actual.push_back(t); });
+    ASSERT_EQ(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i].x, actual[i].x);
+        EXPECT_EQ(expected[i].y, actual[i].y);
+    }
+}
+
+TEST(FrameGraphTest, DotDumpHasNodesEdgesAndTimings) {
+    FrameGraph graph;
+    graph.addSystem("writer", 0, FrameGraph::resources<Input>(), [](float) {});
+    graph.addSystem("reader", FrameGraph::resources<Input>(), 0, [](float) {});
+    graph.runSerial(0.016f);
+
+    std::ostringstream dot;
+    graph.writeDot(dot);
+    const std::string text = dot.str();
+    std::cout << text;
+
+    EXPECT_NE(text.find("digraph FrameGraph {"), std::string::npos);
+    EXPECT_NE(text.find("n0 [label=\"writer\\nreads: -\\nwrites: "), std::string::npos);
+    EXPECT_NE(text.find("n1 [label=\"reader\\nreads: "), std::string::npos);
+    EXPECT_NE(text.find("n0 -> n1;"), std::string::npos);
+    EXPECT_NE(text.find(" ms at +"), std::string::npos);
+    EXPECT_NE(text.find("critical path"), std::string::npos);
+    EXPECT_LE(graph.getCriticalPath(), graph.getLastFrameTime());
+}
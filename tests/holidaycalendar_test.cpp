@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "holidaycalendar.h"
+#include "datetime.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+
+using namespace soul;
+
+namespace {
+
+// Reference implementation stepping one day at a time
+int32_t bruteAddBusinessDays(const HolidayCalendar& holidays, int32_t days, int32_t n) {
+    const int32_t step = n > 0 ? 1 : -1;
+    while (n != 0) {
+        days += step;
+        if (holidays.isBusinessDay(days))
+            n -= step;
+    }
+    return days;
+}
+
+HolidayCalendar randomCalendar(int32_t firstYear, int32_t lastYear, uint32_t seed) {
+    HolidayCalendar holidays(firstYear, lastYear);
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> day(holidays.firstDay(), holidays.lastDay());
+    for (int i = 0; i < (lastYear - firstYear + 1) * 15; ++i)
+        holidays.addHoliday(day(rng));
+    // A long cluster of holidays, as a two weeks closing
+    for (int32_t z = calendar::daysFromCivil(2020, 12, 20); z <= calendar::daysFromCivil(2021, 1, 3); ++z)
+        holidays.addHoliday(z);
+    return holidays;
+}
+
+} // namespace
+
+TEST(HolidayCalendarTest, WeekdayArithmetic) {
+    const int32_t first = calendar::daysFromCivil(1900, 1, 1);
+    const int32_t last = calendar::daysFromCivil(2100, 1, 1);
+    const HolidayCalendar weekends;
+
+    for (int32_t z = first; z < last; z += 3) {
+        for (int32_t n : {-11, -5, -1, 1, 2, 5, 23}) {
+            ASSERT_EQ(calendar::addWeekdays(z, n), bruteAddBusinessDays(weekends, z, n)) << z << " " << n;
+        }
+    }
+
+    int32_t count = 0;
+    for (int32_t z = first; z < first + 1000; ++z) {
+        ASSERT_EQ(calendar::weekdaysBetween(first, z), count);
+        count += !calendar::isWeekend(z);
+    }
+}
+
+TEST(HolidayCalendarTest, AddBusinessDaysMatchesSteppingOverHolidays) {
+    const HolidayCalendar holidays = randomCalendar(2000, 2040, 42);
+    const int32_t first = calendar::daysFromCivil(1999, 6, 1);
+    const int32_t last = calendar::daysFromCivil(2041, 6, 1);
+
+    for (int32_t z = first; z < last; z += 5) {
+        for (int32_t n : {-300, -20, -2, -1, 1, 2, 3, 20, 300}) {
+            const int32_t result = holidays.addBusinessDays(z, n);
+            ASSERT_EQ(result, bruteAddBusinessDays(holidays, z, n)) << z << " " << n;
+            // Business days in (z, result] forward and in [result, z) backward
+            if (n > 0)
+                ASSERT_EQ(holidays.businessDaysBetween(z + 1, result + 1), n);
+            else
+                ASSERT_EQ(holidays.businessDaysBetween(z, result), n);
+        }
+    }
+}
+
+TEST(HolidayCalendarTest, BusinessDaysBetween) {
+    HolidayCalendar holidays(2024, 2024);
+    holidays.addHoliday(2024, 12, 25);  // Wednesday
+    holidays.addHoliday(2024, 12, 28);  // Saturday, no effect on counts
+
+    const int32_t monday = calendar::daysFromCivil(2024, 12, 23);
+    EXPECT_EQ(holidays.businessDaysBetween(monday, monday + 7), 4);
+    EXPECT_EQ(holidays.businessDaysBetween(monday + 7, monday), -4);
+    EXPECT_EQ(holidays.businessDaysBetween(monday, monday), 0);
+    EXPECT_EQ(holidays.businessDaysBetween(monday, monday + 700), calendar::weekdaysBetween(monday, monday + 700) - 1);
+    EXPECT_EQ(holidays.getCountHolidays(), 2);
+
+    holidays.removeHoliday(calendar::daysFromCivil(2024, 12, 25));
+    EXPECT_EQ(holidays.businessDaysBetween(monday, monday + 7), 5);
+    EXPECT_THROW(holidays.addHoliday(2025, 1, 1), std::out_of_range);
+}
+
+TEST(HolidayCalendarTest, RollConventions) {
+    HolidayCalendar holidays(2024, 2025);
+    holidays.addHoliday(2024, 5, 31);  // Friday, end of month
+
+    const int32_t saturday = calendar::daysFromCivil(2024, 6, 1);
+    EXPECT_EQ(holidays.adjust(saturday, RollConvention::Unadjusted), saturday);
+    EXPECT_EQ(holidays.adjust(saturday, RollConvention::Following), calendar::daysFromCivil(2024, 6, 3));
+    EXPECT_EQ(holidays.adjust(saturday, RollConvention::ModifiedFollowing), calendar::daysFromCivil(2024, 6, 3));
+    EXPECT_EQ(holidays.adjust(saturday, RollConvention::Preceding), calendar::daysFromCivil(2024, 5, 30));
+
+    // Following would leave the month
+    const int32_t endOfMonth = calendar::daysFromCivil(2024, 5, 31);
+    EXPECT_EQ(holidays.adjust(endOfMonth, RollConvention::Following), calendar::daysFromCivil(2024, 6, 3));
+    EXPECT_EQ(holidays.adjust(endOfMonth, RollConvention::ModifiedFollowing), calendar::daysFromCivil(2024, 5, 30));
+
+    // A business day is left unchanged
+    const int32_t tuesday = calendar::daysFromCivil(2024, 6, 4);
+    EXPECT_EQ(holidays.adjust(tuesday, RollConvention::Preceding), tuesday);
+}
+
+TEST(HolidayCalendarTest, DateTimeWithHolidays) {
+    HolidayCalendar holidays(2022, 2022);
+    holidays.addHoliday(2022, 1, 3);
+
+    DateTime dt(2021, 12, 31);
+    dt.addBusinessDays(1, holidays);
+    EXPECT_EQ(dt.year_month_day_h(), "2022-01-04");
+    EXPECT_TRUE(dt.isBusinessDay(holidays));
+    EXPECT_EQ(DateTime(2021, 12, 31).businessDaysUntil(dt, holidays), 1);
+
+    DateTime holiday(2022, 1, 3);
+    EXPECT_FALSE(holiday.isBusinessDay(holidays));
+    holiday.roll(RollConvention::Preceding, holidays);
+    EXPECT_EQ(holiday.year_month_day_h(), "2021-12-31");
+}
+
+// Benchmark: settlement dates (T+2 modified following) in batch
+TEST(HolidayCalendarTest, BenchmarkSettlementDates) {
+    constexpr int32_t COUNT = 2000000;
+    const HolidayCalendar holidays = randomCalendar(1990, 2060, 7);
+    const int32_t first = calendar::daysFromCivil(2000, 1, 1);
+
+    int64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < COUNT; ++i) {
+        const int32_t trade = first + i % 20000;
+        checksum += holidays.adjust(holidays.addBusinessDays(trade, 2), RollConvention::ModifiedFollowing);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_NE(checksum, 0);
+    std::cout << std::format("Settlement dates: {:.0f} per second", COUNT / elapsed.count()) << std::endl;
+}
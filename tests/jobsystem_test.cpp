@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include "jobsystem.h"
+#include "time_elapsed.h"
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace soul;
+
+TEST(WorkStealingDequeTest, OwnerIsLifoThievesAreFifo) {
+    WorkStealingDeque deque;
+    Job jobs[3];
+    EXPECT_TRUE(deque.empty());
+    for (Job& job : jobs)
+        EXPECT_TRUE(deque.push(&job));
+
+    EXPECT_EQ(deque.pop(), &jobs[2]);
+    EXPECT_EQ(deque.steal(), &jobs[0]);
+    EXPECT_EQ(deque.pop(), &jobs[1]);
+    EXPECT_EQ(deque.pop(), nullptr);
+    EXPECT_EQ(deque.steal(), nullptr);
+    EXPECT_TRUE(deque.empty());
+}
+
+TEST(WorkStealingDequeTest, FullDequeRefusesPush) {
+    WorkStealingDeque deque;
+    Job job;
+    for (int64_t i = 0; i < WorkStealingDeque::CAPACITY; ++i)
+        ASSERT_TRUE(deque.push(&job));
+    EXPECT_FALSE(deque.push(&job));
+    EXPECT_EQ(deque.steal(), &job);
+    EXPECT_TRUE(deque.push(&job));
+}
+
+TEST(WorkStealingDequeTest, EveryJobIsTakenOnce) {
+    constexpr int COUNT = 100000;
+    constexpr int THIEVES = 3;
+    WorkStealingDeque deque;
+    std::vector<Job> jobs(COUNT);
+    std::vector<std::atomic<int>> taken(COUNT);
+    std::atomic<bool> producing {true};
+
+    auto take = [&](Job* job) { taken[job - jobs.data()].fetch_add(1, std::memory_order_relaxed); };
+
+    std::vector<std::thread> thieves;
+    for (int t = 0; t < THIEVES; ++t) {
+        thieves.emplace_back([&]() {
+            while (producing.load() || !deque.empty()) {
+                if (Job* job = deque.steal())
+                    take(job);
+            }
+        });
+    }
+
+    // The owner pushes and pops back some of its jobs while the thieves steal
+    for (int i = 0; i < COUNT; ++i) {
+        while (!deque.push(&jobs[i])) {
+            if (Job* job = deque.pop())
+                take(job);
+        }
+        if (i % 3 == 0) {
+            if (Job* job = deque.pop())
+                take(job);
+        }
+    }
+    while (Job* job = deque.pop())
+        take(job);
+    producing.store(false);
+    for (auto& thief : thieves)
+        thief.join();
+
+    for (int i = 0; i < COUNT; ++i)
+        ASSERT_EQ(taken[i].load(), 1) << "job " << i;
+}
+
+TEST(JobSystemTest, SubmitAndWait) {
+    JobSystem jobs(3);
+    EXPECT_EQ(jobs.getCountWorkers(), 3u);
+    EXPECT_EQ(jobs.currentWorker(), JobSystem::NO_WORKER);
+
+    std::atomic<int> sum {0};
+    JobCounter counter;
+    for (int i = 1; i <= 100; ++i)
+        jobs.submit([&sum, i]() { sum.fetch_add(i); }, counter);
+    jobs.wait(counter);
+    EXPECT_TRUE(counter.isDone());
+    EXPECT_EQ(sum.load(), 5050);
+}
+
+TEST(JobSystemTest, ParallelForCoversEveryIndexOnce) {
+    JobSystem jobs(4);
+    constexpr size_t COUNT = 100003;
+    std::vector<int> hits(COUNT, 0);
+
+    for (size_t grain : {1, 7, 1000, 200000}) {
+        std::fill(hits.begin(), hits.end(), 0);
+        jobs.parallelFor(COUNT, grain, [&hits, grain](size_t begin, size_t end) {
+            EXPECT_LE(end - begin, grain);
+            for (size_t i = begin; i < end; ++i)
+                hits[i]++;
+        });
+        EXPECT_EQ(std::count(hits.begin(), hits.end(), 1), static_cast<std::ptrdiff_t>(COUNT)) << "grain " << grain;
+    }
+    jobs.parallelFor(0, 10, [](size_t, size_t) { FAIL(); });
+}
+
+TEST(JobSystemTest, NestedParallelFor) {
+    JobSystem jobs(3);
+    std::vector<std::atomic<int>> cells(64 * 64);
+
+    // Waiting inside a job runs other jobs instead of blocking the worker
+    jobs.parallelFor(64, 1, [&](size_t rowBegin, size_t rowEnd) {
+        for (size_t row = rowBegin; row < rowEnd; ++row) {
+            jobs.parallelFor(64, 8, [&cells, row](size_t begin, size_t end) {
+                for (size_t col = begin; col < end; ++col)
+                    cells[row * 64 + col].fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+    });
+    for (const auto& cell : cells)
+        EXPECT_EQ(cell.load(), 1);
+}
+
+TEST(JobSystemTest, ErrorsAreRethrownByWait) {
+    JobSystem jobs(2);
+    JobCounter counter;
+    std::atomic<int> ran {0};
+    for (int i = 0; i < 10; ++i) {
+        jobs.submit([&ran, i]() {
+            ran.fetch_add(1);
+            if (i == 5)
+                throw std::runtime_error("job 5");
+        }, counter);
+    }
+    EXPECT_THROW(jobs.wait(counter), std::runtime_error);
+    EXPECT_EQ(ran.load(), 10);
+
+    EXPECT_THROW(jobs.parallelFor(1000, 10, [](size_t begin, size_t) {
+        if (begin == 0)
+            throw std::invalid_argument("first range");
+    }), std::invalid_argument);
+
+    // The pool keeps working
+    std::atomic<size_t> count {0};
+    jobs.parallelFor(1000, 10, [&count](size_t begin, size_t end) { count += end - begin; });
+    EXPECT_EQ(count.load(), 1000u);
+}
+
+TEST(JobSystemTest, IdleWorkersWakeUp) {
+    JobSystem jobs(2);
+    for (int round = 0; round < 5; ++round) {
+        // Long enough for the workers to go to sleep
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        JobCounter counter;
+        std::atomic<int> done {0};
+        for (int i = 0; i < 8; ++i)
+            jobs.submit([&done]() { done.fetch_add(1); }, counter);
+        jobs.wait(counter);
+        EXPECT_EQ(done.load(), 8);
+    }
+}
+
+TEST(JobSystemTest, WaitSleepsUntilTheJobIsDone) {
+    JobSystem jobs(1);
+    JobCounter counter;
+    std::atomic<bool> done {false};
+    // Long enough for the caller to stop spinning and sleep on the counter
+    jobs.submit([&done]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        done.store(true);
+    }, counter);
+    jobs.wait(counter);
+    EXPECT_TRUE(done.load());
+}
+
+TEST(JobSystemTest, QueuedJobsAreReleased) {
+    auto payload = std::make_shared<int>(0);
+    JobCounter inner;
+    {
+        JobSystem jobs(1);
+        JobCounter outer;
+        std::atomic<bool> queued {false};
+        jobs.submit([&]() {
+            // Pushed to the deque of the only worker, still busy with this job when stopped
+            for (int i = 0; i < 16; ++i)
+                jobs.submit([payload]() {}, inner);
+            queued.store(true);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }, outer);
+        while (!queued.load())
+            std::this_thread::yield();
+    }
+    EXPECT_EQ(payload.use_count(), 1);
+}
+
+TEST(JobSystemTest, BenchmarkScaling) {
+    constexpr size_t COUNT = 1 << 21;
+    std::vector<float> values(COUNT);
+    std::iota(values.begin(), values.end(), 0.0f);
+    std::vector<float> out(COUNT);
+
+    auto kernel = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            out[i] = std::sqrt(values[i]) * std::sin(values[i]) + std::cos(values[i] * 0.5f);
+    };
+
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    kernel(0, COUNT);
+    const double serialMs = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count();
+    const std::vector<float> expected = out;
+
+    const size_t cores = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t workers = 1; workers <= std::max<size_t>(4, cores); workers *= 2) {
+        JobSystem jobs(workers);
+        elapsed.start();
+        jobs.parallelFor(COUNT, 4096, kernel);
+        const double ms = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count();
+        EXPECT_EQ(out, expected);
+        std::cout << std::format("parallelFor {} items, {} workers + caller: {:.2f} ms ({:.2f}x serial {:.2f} ms), {} stolen\n",
+            COUNT, workers, ms, serialMs / ms, serialMs, jobs.getStolenJobs());
+    }
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "latencyhistogram.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+using namespace soul;
+
+TEST(LatencyHistogramTest, BucketsKeepRelativePrecision) {
+    for (uint64_t value = 0; value < 5000000; value += 1 + value / 97) {
+        const size_t index = LatencyHistogram::indexOf(value);
+        const uint64_t highest = LatencyHistogram::highestValueOf(index);
+        ASSERT_GE(highest, value);
+        ASSERT_LE(static_cast<double>(highest - value), static_cast<double>(value) / LatencyHistogram::SUB_BUCKET_COUNT + 1.0);
+        ASSERT_EQ(LatencyHistogram::indexOf(highest), index);
+    }
+}
+
+TEST(LatencyHistogramTest, PercentilesMatchSortedValues) {
+    std::mt19937_64 rng(1);
+    // Frame times: mostly 16.6 ms, with a tail of stutters
+    std::lognormal_distribution<double> distribution(std::log(16.6e6), 0.15);
+
+    LatencyHistogram histogram;
+    std::vector<uint64_t> values;
+    for (int i = 0; i < 100000; ++i) {
+        const uint64_t value = static_cast<uint64_t>(distribution(rng)) + (i % 1000 == 0 ? 100000000 : 0);
+        histogram.record(value);
+        values.push_back(value);
+    }
+    std::sort(values.begin(), values.end());
+
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        const double exact = static_cast<double>(values[static_cast<size_t>(p / 100.0 * values.size()) - 1]);
+        const double estimate = static_cast<double>(histogram.percentile(p).count());
+        EXPECT_NEAR(estimate, exact, exact / LatencyHistogram::SUB_BUCKET_COUNT) << p;
+    }
+
+    EXPECT_EQ(histogram.count(), values.size());
+    EXPECT_EQ(static_cast<uint64_t>(histogram.max().count()), values.back());
+    EXPECT_EQ(static_cast<uint64_t>(histogram.min().count()), values.front());
+    EXPECT_EQ(histogram.percentile(100.0), histogram.max());
+}
+
+TEST(LatencyHistogramTest, MergePerThreadInstances) {
+    LatencyHistogram a, b, all;
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        (v % 2 ? a : b).record(v * 1000);
+        all.record(v * 1000);
+    }
+
+    a.merge(b);
+    EXPECT_EQ(a.count(), all.count());
+    EXPECT_EQ(a.mean(), all.mean());
+    EXPECT_EQ(a.percentile(99.0), all.percentile(99.0));
+    EXPECT_EQ(a.min(), std::chrono::microseconds(1));
+    EXPECT_EQ(a.max(), std::chrono::milliseconds(1));
+
+    a.reset();
+    EXPECT_EQ(a.count(), 0u);
+    EXPECT_EQ(a.percentile(50.0).count(), 0);
+    EXPECT_EQ(a.min().count(), 0);
+
+    // Clamped to the largest trackable value
+    a.record(std::chrono::hours(24));
+    EXPECT_EQ(static_cast<uint64_t>(a.max().count()), LatencyHistogram::MAX_VALUE);
+}
+
+TEST(LatencyHistogramTest, BenchmarkRecord) {
+    constexpr int RECORDS = 10000000;
+    LatencyHistogram histogram;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < RECORDS; ++i)
+        histogram.record(static_cast<uint64_t>(i) * 2654435761u % 50000000u);
+    const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / RECORDS;
+
+    EXPECT_EQ(histogram.count(), static_cast<uint64_t>(RECORDS));
+    std::cout << std::format("LatencyHistogram::record: {:.2f} ns", ns) << std::endl;
+}
@@ -1,6 +1,11 @@
 #include <gtest/gtest.h>
 #include "logger.h"
 #include <sstream>
+#include <filesystem>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
 
 using namespace soul;
 using namespace std;
@@ -29,4 +34,294 @@ TEST(LoggerTest, BasicAssertions) {
     logManager.logWarn("This is an example 8 of logWarn with argument {}", 55);
     logManager.logError("This is an example 9 of logError with argument {}", 55);
     logManager.logInfo("Example 10 of log without argument");
-}
\ No newline at end of file
+}
+
+TEST(LoggerTest, FileLoggerBuffersAndRotates) {
+    namespace fs = std::filesystem;
+    const fs::path dir = fs::temp_directory_path() / "goku_logger_test";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    const fs::path logPath = dir / "goku.log";
+
+    LoggerFileOptions options;
+    options.bufferSize = 1024;
+    options.flushInterval = std::chrono::hours(1);
+    options.maxFileSize = 4096;
+    options.maxHistory = 2;
+
+    {
+        LoggerFile logger(LOG_LEVEL::LOG_DEBUG, logPath.string(), options);
+
+        // Nothing is written to disk before the buffer is full
+        logger.write(LOG_LEVEL::LOG_INFO, "first line");
+        EXPECT_EQ(fs::file_size(logPath), 0u);
+
+        logger.flush();
+        EXPECT_GT(fs::file_size(logPath), 0u);
+
+        for (int i = 0; i < 500; ++i)
+            logger.write(LOG_LEVEL::LOG_INFO, std::format("line {} of the rotation test", i));
+        logger.flush();
+
+        auto stats = logger.getStats();
+        EXPECT_EQ(stats.linesWritten, 501u);
+        EXPECT_GT(stats.rotationCount, 2u);
+        EXPECT_GT(stats.bytesPerSecond(), 0.0);
+        cout << std::format("LoggerFile: {} lines, {} bytes, {} flushes, {:.1f} MB/s to disk", 
+            stats.linesWritten, stats.bytesWritten, stats.flushCount, stats.diskBytesPerSecond() / 1e6) << endl;
+    }
+
+    // Current file plus the history kept
+    size_t fileCount = 0;
+    for (const auto& entry : fs::directory_iterator(dir)) {
+        EXPECT_LE(fs::file_size(entry.path()), options.maxFileSize + options.bufferSize);
+        fileCount++;
+    }
+    EXPECT_EQ(fileCount, options.maxHistory + 1);
+
+    fs::remove_all(dir);
+}
+
+TEST(LoggerTest, FileLoggerFlushesIdleLines) {
+    namespace fs = std::filesystem;
+    const fs::path logPath = fs::temp_directory_path() / "goku_logger_idle.log";
+
+    LoggerFileOptions options;
+    options.flushInterval = std::chrono::milliseconds(50);
+
+    LoggerFile logger(LOG_LEVEL::LOG_DEBUG, logPath.string(), options);
+    logger.write(LOG_LEVEL::LOG_INFO, "last line of a burst");
+
+    // No other write comes, the flusher writes the line once the interval is over
+    std::string content;
+    for (int i = 0; i < 40 && content.find("last line of a burst") == std::string::npos; ++i) {
+        std::this_thread::sleep_for(options.flushInterval);
+        std::ifstream file(logPath);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    EXPECT_NE(content.find("last line of a burst"), std::string::npos);
+    EXPECT_GE(logger.getStats().flushCount, 1u);
+
+    fs::remove(logPath);
+}
+
+namespace {
+
+// Sink keeping the lines in memory to check them once the threads are joined
+class LoggerMemory : public ILogger {
+public:
+    explicit LoggerMemory(const LOG_LEVEL level) : ILogger(level) {}
+
+    void write(const LOG_LEVEL, const string& s) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lines_.push_back(s);
+    }
+
+    vector<string> lines() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return lines_;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    vector<string> lines_;
+};
+
+} // namespace
+
+// Run with -DSOUL_ENABLE_TSAN=ON to check the sink registration against concurrent logging
+TEST(LoggerTest, ConcurrentLoggingWhileSinksChange) {
+    auto& logManager = LoggerManager::getInstance();
+
+    constexpr int THREADS = 4;
+    constexpr int LINES = 2000;
+
+    auto memory = make_shared<LoggerMemory>(LOG_LEVEL::LOG_DEBUG);
+    logManager.addLogger(memory);
+
+    std::atomic<bool> done {false};
+    std::thread registrar([&]() {
+        // Sinks come and go while the workers are logging
+        while (!done.load()) {
+            auto transient = make_shared<LoggerMemory>(LOG_LEVEL::LOG_DEBUG);
+            logManager.addLogger(transient);
+            logManager.removeLogger(transient);
+        }
+    });
+
+    vector<std::thread> workers;
+    for (int t = 0; t < THREADS; ++t) {
+        workers.emplace_back([&logManager, t]() {
+            for (int i = 0; i < LINES; ++i)
+                logManager.logDebug("worker {} line {} end", t, i);
+        });
+    }
+    for (auto& w : workers)
+        w.join();
+
+    done.store(true);
+    registrar.join();
+    logManager.removeLogger(memory);
+    // Once the workers are gone every replaced list is freed
+    EXPECT_EQ(logManager.getRetiredSinkLists(), 0u);
+
+    const auto lines = memory->lines();
+    ASSERT_EQ(lines.size(), static_cast<size_t>(THREADS * LINES));
+
+    // Every line arrives whole and every line of a worker arrives in order
+    vector<int> next(THREADS, 0);
+    for (const auto& line : lines) {
+        int t = -1, i = -1;
+        char tail[4] = {};
+        ASSERT_EQ(std::sscanf(line.c_str(), "worker %d line %d %3s", &t, &i, tail), 3) << line;
+        ASSERT_STREQ(tail, "end");
+        ASSERT_EQ(i, next[t]++);
+    }
+}
+
+TEST(LoggerTest, RemovedSinkIsReleased) {
+    // Sink telling when it is destroyed
+    class LoggerProbe : public LoggerMemory {
+    public:
+        explicit LoggerProbe(std::atomic<bool>& destroyed) : LoggerMemory(LOG_LEVEL::LOG_DEBUG), destroyed_(destroyed) {}
+        ~LoggerProbe() override { destroyed_.store(true); }
+
+    private:
+        std::atomic<bool>& destroyed_;
+    };
+
+    auto& logManager = LoggerManager::getInstance();
+    std::atomic<bool> destroyed {false};
+    {
+        auto probe = make_shared<LoggerProbe>(destroyed);
+        logManager.addLogger(probe);
+        logManager.logDebug("probe line");
+        EXPECT_EQ(probe->lines().size(), 1u);
+        logManager.removeLogger(probe);
+    }
+    // No log call holds the old list any more, the manager kept no reference
+    EXPECT_TRUE(destroyed.load());
+    EXPECT_EQ(logManager.getRetiredSinkLists(), 0u);
+
+    // A file sink is flushed and closed as soon as it is removed
+    namespace fs = std::filesystem;
+    const fs::path logPath = fs::temp_directory_path() / "goku_logger_removed.log";
+    {
+        auto file = make_shared<LoggerFile>(LOG_LEVEL::LOG_DEBUG, logPath.string());
+        logManager.addLogger(file);
+        logManager.logDebug("last line of the file");
+        logManager.removeLogger(file);
+    }
+    std::ifstream log(logPath);
+    const string content((std::istreambuf_iterator<char>(log)), std::istreambuf_iterator<char>());
+    EXPECT_NE(content.find("last line of the file"), string::npos);
+    fs::remove(logPath);
+}
+
+TEST(LoggerTest, ConcurrentFileLoggerLinesAreNotTorn) {
+    namespace fs = std::filesystem;
+    const fs::path logPath = fs::temp_directory_path() / "goku_logger_concurrent.log";
+
+    constexpr int THREADS = 4;
+    constexpr int LINES = 1000;
+
+    LoggerFileOptions options;
+    options.bufferSize = 512;
+    {
+        LoggerFile logger(LOG_LEVEL::LOG_DEBUG, logPath.string(), options);
+
+        vector<std::thread> workers;
+        for (int t = 0; t < THREADS; ++t) {
+            workers.emplace_back([&logger, t]() {
+                for (int i = 0; i < LINES; ++i)
+                    logger.write(LOG_LEVEL::LOG_INFO, std::format("worker {} line {} end", t, i));
+            });
+        }
+        for (auto& w : workers)
+            w.join();
+    }
+
+    std::ifstream file(logPath);
+    string line;
+    std::getline(file, line); // header
+    int count = 0;
+    while (std::getline(file, line)) {
+        EXPECT_NE(line.find("] worker "), string::npos) << line;
+        EXPECT_TRUE(line.ends_with(" end")) << line;
+        count++;
+    }
+    EXPECT_EQ(count, THREADS * LINES);
+
+    fs::remove(logPath);
+}
+
+TEST(LoggerTest, RateLimitedLogging) {
+    auto& logManager = LoggerManager::getInstance();
+    auto memory = make_shared<LoggerMemory>(LOG_LEVEL::LOG_DEBUG);
+    logManager.addLogger(memory);
+
+    for (int i = 0; i < 1000; ++i)
+        SOUL_LOG_EVERY_N(logManager, 100, LOG_LEVEL::LOG_DEBUG, "every 100: {}", i);
+    for (int i = 0; i < 1000; ++i)
+        SOUL_LOG_FIRST_N(logManager, 3, LOG_LEVEL::LOG_DEBUG, "first 3: {}", i);
+    for (int i = 0; i < 1000; ++i)
+        SOUL_LOG_EVERY_INTERVAL(logManager, std::chrono::hours(1), LOG_LEVEL::LOG_DEBUG, "once per hour: {}", i);
+
+    // Verbose level is below the sink level: nothing is formatted nor written
+    EXPECT_FALSE(logManager.isEnabled(LOG_LEVEL::LOG_DEBUGVERBOSE));
+    EXPECT_TRUE(logManager.isEnabled(LOG_LEVEL::LOG_DEBUG));
+
+    auto lines = memory->lines();
+    ASSERT_EQ(lines.size(), 10u + 3u + 1u);
+    EXPECT_EQ(lines[1], "every 100: 100");
+    EXPECT_EQ(lines[12], "first 3: 2");
+    EXPECT_EQ(lines[13], "once per hour: 0");
+
+    // Sampling keeps one message of the level out of n
+    logManager.setSamplingRate(LOG_LEVEL::LOG_DEBUG, 10);
+    for (int i = 0; i < 100; ++i)
+        logManager.logDebug("sampled {}", i);
+    logManager.setSamplingRate(LOG_LEVEL::LOG_DEBUG, 1);
+    EXPECT_EQ(logManager.getSamplingRate(LOG_LEVEL::LOG_DEBUG), 1u);
+
+    EXPECT_EQ(memory->lines().size(), lines.size() + 10u);
+
+    logManager.removeLogger(memory);
+}
+
+TEST(LoggerTest, CategoriesFilterBeforeFormatting) {
+    auto& logManager = LoggerManager::getInstance();
+    auto memory = make_shared<LoggerMemory>(LOG_LEVEL::LOG_ERROR);
+    logManager.addLogger(memory);
+
+    const LogCategory states = logManager.registerCategory("TestStates");
+    const LogCategory assets = logManager.registerCategory("TestAssets", LOG_LEVEL::LOG_WARNING);
+
+    // Registering the same name returns the same category
+    EXPECT_EQ(logManager.registerCategory("TestStates").id, states.id);
+    EXPECT_NE(states.id, assets.id);
+    EXPECT_EQ(logManager.categoryName(assets), "TestAssets");
+
+    EXPECT_TRUE(logManager.isEnabled(states, LOG_LEVEL::LOG_INFO));
+    EXPECT_FALSE(logManager.isEnabled(states, LOG_LEVEL::LOG_DEBUG));
+    EXPECT_FALSE(logManager.isEnabled(assets, LOG_LEVEL::LOG_INFO));
+
+    // Trace one subsystem only: the sink level does not apply to categories
+    logManager.setCategoryLevel(states, LOG_LEVEL::LOG_DEBUG);
+    logManager.log(states, LOG_LEVEL::LOG_DEBUG, "enter {}", "Idle");
+    logManager.log(assets, LOG_LEVEL::LOG_DEBUG, "texture {}", "block");
+    logManager.log(assets, LOG_LEVEL::LOG_WARNING, "texture {} missing", "enemy");
+
+    logManager.setCategoryEnabled(states, false);
+    EXPECT_FALSE(logManager.isEnabled(states, LOG_LEVEL::LOG_ERROR));
+    logManager.log(states, LOG_LEVEL::LOG_ERROR, "not logged");
+    logManager.setCategoryEnabled(states, true);
+    EXPECT_EQ(logManager.getCategoryLevel(states), LOG_LEVEL::LOG_DEBUG);
+
+    const auto lines = memory->lines();
+    ASSERT_EQ(lines.size(), 2u);
+    EXPECT_EQ(lines[0], "[TestStates] enter Idle");
+    EXPECT_EQ(lines[1], "[TestAssets] texture enemy missing");
+
+    logManager.removeLogger(memory);
+}
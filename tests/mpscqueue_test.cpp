@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+#include "mpscqueue.h"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace soul;
+
+TEST(MpscQueueTest, DrainsInPushOrder) {
+    MpscQueue<int> queue;
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 5; ++i)
+        queue.push(i);
+    EXPECT_FALSE(queue.empty());
+
+    std::vector<int> values;
+    EXPECT_EQ(queue.drain([&values](int&& v) { values.push_back(v); }), 5u);
+    EXPECT_EQ(values, (std::vector<int>{0, 1, 2, 3, 4}));
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.drain([](int&&) {}), 0u);
+}
+
+TEST(MpscQueueTest, MoveOnlyItemsAreFreed) {
+    auto shared = std::make_shared<int>(42);
+    {
+        MpscQueue<std::shared_ptr<int>> queue;
+        queue.push(shared);
+        queue.push(shared);
+        EXPECT_EQ(shared.use_count(), 3);
+    }
+    // The destructor drains what was left
+    EXPECT_EQ(shared.use_count(), 1);
+}
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+    constexpr int PRODUCERS = 4;
+    constexpr int ITEMS = 20000;
+    MpscQueue<std::pair<int, int>> queue;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < ITEMS; ++i)
+                queue.push({p, i});
+        });
+    }
+
+    // The consumer drains while the producers push, each producer's items stay in order
+    std::vector<int> next(PRODUCERS, 0);
+    int total = 0;
+    auto consume = [&](std::pair<int, int>&& item) {
+        EXPECT_EQ(item.second, next[item.first]);
+        next[item.first] = item.second + 1;
+        ++total;
+    };
+    while (total < PRODUCERS * ITEMS)
+        queue.drain(consume);
+
+    for (auto& producer : producers)
+        producer.join();
+    EXPECT_TRUE(queue.empty());
+    for (int p = 0; p < PRODUCERS; ++p)
+        EXPECT_EQ(next[p], ITEMS);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "objectpool.h"
+#include "time_elapsed.h"
+#include <format>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace soul;
+
+namespace {
+
+struct Particle {
+    static inline int alive = 0;
+
+    Particle(float x, float y) : x(x), y(y) { ++alive; }
+    ~Particle() { --alive; }
+
+    float x;
+    float y;
+    float life {1.0f};
+};
+
+struct alignas(64) Aligned {
+    char data[3];
+};
+
+struct Throwing {
+    explicit Throwing(bool fail) {
+        if (fail)
+            throw std::runtime_error("constructor failed");
+    }
+};
+
+} // namespace
+
+TEST(ObjectPoolTest, AcquireConstructsAndReleaseDestroys) {
+    ObjectPool<Particle> pool(8);
+    Particle* p = pool.acquire(1.0f, 2.0f);
+    EXPECT_EQ(p->x, 1.0f);
+    EXPECT_EQ(p->y, 2.0f);
+    EXPECT_EQ(Particle::alive, 1);
+    EXPECT_EQ(pool.stats().live, 1u);
+
+    pool.release(p);
+    EXPECT_EQ(Particle::alive, 0);
+    EXPECT_EQ(pool.stats().live, 0u);
+
+    // The last released block is given back first
+    Particle* q = pool.acquire(3.0f, 4.0f);
+    EXPECT_EQ(q, p);
+    pool.release(q);
+}
+
+TEST(ObjectPoolTest, BlocksOfASlabAreContiguousAndAligned) {
+    ObjectPool<Particle> pool(4);
+    Particle* a = pool.acquire(0.0f, 0.0f);
+    Particle* b = pool.acquire(0.0f, 0.0f);
+    // Blocks are padded to hold the free list link
+    const size_t stride = (sizeof(Particle) + alignof(void*) - 1) / alignof(void*) * alignof(void*);
+    EXPECT_EQ(reinterpret_cast<std::byte*>(b) - reinterpret_cast<std::byte*>(a), static_cast<std::ptrdiff_t>(stride));
+    pool.release(a);
+    pool.release(b);
+
+    ObjectPool<Aligned> aligned(4);
+    std::vector<Aligned*> blocks;
+    for (int i = 0; i < 10; ++i) {
+        blocks.push_back(aligned.acquire());
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(blocks.back()) % 64, 0u);
+    }
+    for (Aligned* block : blocks)
+        aligned.release(block);
+}
+
+TEST(ObjectPoolTest, GrowthPolicies) {
+    ObjectPool<Particle> fixed(4, PoolGrowth::Fixed);
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 4; ++i)
+        particles.push_back(fixed.acquire(0.0f, 0.0f));
+    EXPECT_THROW(fixed.acquire(0.0f, 0.0f), std::length_error);
+    EXPECT_EQ(fixed.stats().capacity, 4u);
+    EXPECT_DOUBLE_EQ(fixed.stats().occupancy(), 1.0);
+    for (Particle* p : particles)
+        fixed.release(p);
+    particles.clear();
+
+    ObjectPool<Particle> linear(4, PoolGrowth::Linear);
+    for (int i = 0; i < 10; ++i)
+        particles.push_back(linear.acquire(0.0f, 0.0f));
+    EXPECT_EQ(linear.stats().capacity, 12u);
+    EXPECT_EQ(linear.stats().slabs, 3u);
+    for (Particle* p : particles)
+        linear.release(p);
+    particles.clear();
+
+    ObjectPool<Particle> doubling(4, PoolGrowth::Doubling);
+    for (int i = 0; i < 10; ++i)
+        particles.push_back(doubling.acquire(0.0f, 0.0f));
+    // 4, then 4 more, then 8 more
+    EXPECT_EQ(doubling.stats().capacity, 16u);
+    EXPECT_EQ(doubling.stats().slabs, 3u);
+    for (Particle* p : particles)
+        doubling.release(p);
+
+    // Reserve grows past a fixed size too
+    ObjectPool<Particle> reserved(4, PoolGrowth::Fixed);
+    reserved.reserve(100);
+    EXPECT_GE(reserved.stats().capacity, 100u);
+}
+
+TEST(ObjectPoolTest, StatsTrackOccupancy) {
+    ObjectPool<Particle> pool(16);
+    std::vector<Particle*> particles;
+    for (int i = 0; i < 12; ++i)
+        particles.push_back(pool.acquire(0.0f, 0.0f));
+    for (int i = 0; i < 8; ++i) {
+        pool.release(particles.back());
+        particles.pop_back();
+    }
+
+    const ObjectPoolStats& stats = pool.stats();
+    EXPECT_EQ(stats.live, 4u);
+    EXPECT_EQ(stats.peak, 12u);
+    EXPECT_EQ(stats.acquires, 12u);
+    EXPECT_EQ(stats.releases, 8u);
+    EXPECT_DOUBLE_EQ(stats.occupancy(), 0.25);
+    for (Particle* p : particles)
+        pool.release(p);
+}
+
+TEST(ObjectPoolTest, FailedConstructionFreesTheBlock) {
+    ObjectPool<Throwing> pool(4);
+    EXPECT_THROW(pool.acquire(true), std::runtime_error);
+    EXPECT_EQ(pool.stats().live, 0u);
+    pool.release(pool.acquire(false));
+}
+
+TEST(ObjectPoolTest, SharedObjectsGoBackToThePool) {
+    ObjectPool<Particle> pool(8);
+    std::weak_ptr<Particle> weak;
+    {
+        std::shared_ptr<Particle> a = pool.acquireShared(1.0f, 2.0f);
+        std::shared_ptr<Particle> b = a;
+        weak = a;
+        EXPECT_EQ(pool.stats().live, 1u);
+        EXPECT_EQ(a->y, 2.0f);
+    }
+    EXPECT_TRUE(weak.expired());
+    EXPECT_EQ(Particle::alive, 0);
+    EXPECT_EQ(pool.stats().live, 0u);
+    weak.reset();
+
+    // Once warm, spawning and killing does not grow the pools any more
+    std::vector<std::shared_ptr<Particle>> particles;
+    for (int frame = 0; frame < 100; ++frame) {
+        for (int i = 0; i < 8; ++i)
+            particles.push_back(pool.acquireShared(0.0f, 0.0f));
+        particles.clear();
+    }
+    EXPECT_EQ(pool.stats().capacity, 8u);
+    EXPECT_EQ(pool.stats().slabs, 1u);
+    EXPECT_EQ(pool.stats().acquires, 801u);
+}
+
+TEST(ObjectPoolTest, BenchmarkAcquireRelease) {
+    constexpr int COUNT = 10000;
+    constexpr int ROUNDS = 100;
+    ObjectPool<Particle> pool(COUNT);
+    std::vector<std::shared_ptr<Particle>> particles;
+    particles.reserve(COUNT);
+
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (int i = 0; i < COUNT; ++i)
+            particles.push_back(pool.acquireShared(0.0f, 0.0f));
+        particles.clear();
+    }
+    const double poolNs = static_cast<double>(elapsed.elapsed().count()) / (COUNT * ROUNDS);
+
+    elapsed.start();
+    for (int round = 0; round < ROUNDS; ++round) {
+        for (int i = 0; i < COUNT; ++i)
+            particles.push_back(std::make_shared<Particle>(0.0f, 0.0f));
+        particles.clear();
+    }
+    const double heapNs = static_cast<double>(elapsed.elapsed().count()) / (COUNT * ROUNDS);
+
+    EXPECT_EQ(pool.stats().slabs, 1u);
+    std::cout << std::format("shared_ptr spawn and release: pool {:.1f} ns, make_shared {:.1f} ns\n", poolNs, heapNs);
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include "perfcounters.h"
+#include <format>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace soul;
+
+namespace {
+
+const PerfZoneStats* findZone(const std::vector<PerfZoneStats>& stats, const char* name) {
+    for (const auto& zone : stats) {
+        if (std::string_view(zone.name) == name)
+            return &zone;
+    }
+    return nullptr;
+}
+
+// Some work the compiler cannot remove
+uint64_t work(uint64_t iterations) {
+    volatile uint64_t sum = 0;
+    for (uint64_t i = 0; i < iterations; ++i)
+        sum = sum + i * 7;
+    return sum;
+}
+
+} // namespace
+
+class PerfCountersTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profiler.setEnabled(true);
+        profiler.reset();
+        counters.setEnabled(true);
+        counters.reset();
+    }
+
+    void TearDown() override {
+        counters.setEnabled(false);
+    }
+
+    Profiler& profiler = Profiler::getInstance();
+    PerfCounters& counters = PerfCounters::getInstance();
+};
+
+TEST_F(PerfCountersTest, DisabledRecordsNothing) {
+    counters.setEnabled(false);
+    {
+        PerfScope scope("disabled", 10);
+        work(1000);
+    }
+    EXPECT_TRUE(counters.endFrame().empty());
+}
+
+TEST_F(PerfCountersTest, ProfilerTimingIsKeptWithOrWithoutCounters) {
+    {
+        SOUL_PROFILE_COUNTERS("counted", 100);
+        work(10000);
+    }
+    const auto& stats = profiler.endFrame();
+    ASSERT_EQ(stats.size(), 1u);
+    EXPECT_STREQ(stats[0].name, "counted");
+    EXPECT_GT(stats[0].total.count(), 0);
+
+    // Without perf events the zone degrades to the profiler timing only
+    const auto& perf = counters.endFrame();
+    if (!counters.isAvailable()) {
+        EXPECT_TRUE(perf.empty());
+        EXPECT_FALSE(counters.getStatus().empty());
+    }
+}
+
+TEST_F(PerfCountersTest, CountsInstructionsPerItem) {
+    if (!counters.isAvailable())
+        GTEST_SKIP() << counters.getStatus();
+
+    for (int i = 0; i < 4; ++i) {
+        PerfScope scope("loop", 1000);
+        work(100000);
+    }
+
+    const auto& stats = counters.endFrame();
+    const PerfZoneStats* zone = findZone(stats, "loop");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->calls, 4u);
+    EXPECT_EQ(zone->items, 4000u);
+    EXPECT_TRUE(zone->has(PerfEvent::Cycles));
+
+    if (zone->has(PerfEvent::Instructions)) {
+        // At least a few instructions per iteration of the loop
+        EXPECT_GT(zone->total(PerfEvent::Instructions), 400000u);
+        EXPECT_GT(zone->ipc(), 0.0);
+        EXPECT_GT(zone->perItem(PerfEvent::Instructions), 100.0);
+    }
+
+    std::cout << std::format("loop: IPC {:.2f}, L1D misses/item {:.3f}, LLC misses/item {:.3f}, branch misses/item {:.3f}\n",
+        zone->ipc(), zone->perItem(PerfEvent::L1DMisses), zone->perItem(PerfEvent::LLCMisses), zone->perItem(PerfEvent::BranchMisses));
+
+    // The next frame starts empty
+    EXPECT_TRUE(counters.endFrame().empty());
+}
+
+TEST_F(PerfCountersTest, ThreadsAreSummedPerZone) {
+    if (!counters.isAvailable())
+        GTEST_SKIP() << counters.getStatus();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < 10; ++i) {
+                PerfScope scope("worker", 5);
+                work(1000);
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const PerfZoneStats* zone = findZone(counters.endFrame(), "worker");
+    ASSERT_NE(zone, nullptr);
+    EXPECT_EQ(zone->calls, 30u);
+    EXPECT_EQ(zone->items, 150u);
+}
+
+TEST_F(PerfCountersTest, ExitedThreadsReleaseTheirCounters) {
+    // Opened or not, every thread asking for its counters is registered
+    counters.threadGroup();
+    const size_t before = counters.getThreadCount();
+
+    for (int round = 0; round < 3; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t)
+            threads.emplace_back([this]() { counters.threadGroup(); });
+        for (auto& thread : threads)
+            thread.join();
+        EXPECT_EQ(counters.getThreadCount(), before);
+    }
+}
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include "profiler.h"
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace soul;
+
+namespace {
+
+const ProfileZoneStats* findZone(const std::vector<ProfileZoneStats>& stats, const char* name) {
+    for (const auto& zone : stats) {
+        if (std::string_view(zone.name) == name)
+            return &zone;
+    }
+    return nullptr;
+}
+
+void work(std::chrono::microseconds duration) {
+    const auto end = std::chrono::steady_clock::now() + duration;
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+} // namespace
+
+class ProfilerTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        profiler.setEnabled(true);
+        profiler.reset();
+    }
+
+    Profiler& profiler = Profiler::getInstance();
+};
+
+TEST_F(ProfilerTest, NestedZonesAggregatePerFrame) {
+    {
+        SOUL_PROFILE_SCOPE("frame");
+        for (int i = 0; i < 3; ++i) {
+            SOUL_PROFILE_SCOPE("update");
+            work(std::chrono::microseconds(200));
+        }
+        SOUL_PROFILE_SCOPE("render");
+        work(std::chrono::microseconds(100));
+    }
+
+    const auto& stats = profiler.endFrame();
+    ASSERT_EQ(stats.size(), 3u);
+
+    const ProfileZoneStats* frame = findZone(stats, "frame");
+    const ProfileZoneStats* update = findZone(stats, "update");
+    const ProfileZoneStats* render = findZone(stats, "render");
+    ASSERT_TRUE(frame && update && render);
+
+    EXPECT_EQ(frame->depth, 0u);
+    EXPECT_EQ(frame->parent, nullptr);
+    EXPECT_EQ(update->depth, 1u);
+    EXPECT_EQ(std::string_view(update->parent), "frame");
+    EXPECT_EQ(update->count, 3u);
+    EXPECT_GE(update->min, std::chrono::microseconds(200));
+    EXPECT_LE(update->min, update->max);
+    EXPECT_GE(frame->total, update->total + render->total);
+
+    // Statistics are per frame
+    EXPECT_TRUE(profiler.endFrame().empty());
+    EXPECT_TRUE(profiler.getFrameStats().empty());
+}
+
+TEST_F(ProfilerTest, ThreadsRecordIntoTheirOwnBuffers) {
+    constexpr int THREADS = 4;
+    constexpr int ZONES = 1000;
+    // Threads of the other suites may have filled their buffers, never drained
+    const uint64_t dropped = profiler.getDroppedEvents();
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < ZONES; ++i) {
+                SOUL_PROFILE_SCOPE("worker");
+                SOUL_PROFILE_SCOPE("job");
+            }
+        });
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    const auto& stats = profiler.endFrame();
+    const ProfileZoneStats* worker = findZone(stats, "worker");
+    const ProfileZoneStats* job = findZone(stats, "job");
+    ASSERT_TRUE(worker && job);
+    EXPECT_EQ(worker->count, static_cast<uint32_t>(THREADS * ZONES));
+    EXPECT_EQ(job->count, static_cast<uint32_t>(THREADS * ZONES));
+    EXPECT_EQ(profiler.getDroppedEvents(), dropped);
+}
+
+TEST_F(ProfilerTest, ChromeTraceExport) {
+    profiler.beginCapture();
+    for (int frame = 0; frame < 2; ++frame) {
+        {
+            SOUL_PROFILE_SCOPE("Game::frame");
+            SOUL_PROFILE_SCOPE("Scene \"update\"");
+        }
+        profiler.endFrame();
+    }
+    profiler.endCapture();
+
+    // Not captured
+    { SOUL_PROFILE_SCOPE("ignored"); }
+    profiler.endFrame();
+
+    EXPECT_EQ(profiler.getCaptureSize(), 4u);
+
+    std::ostringstream out;
+    profiler.writeChromeTrace(out);
+    const std::string json = out.str();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0u);
+    EXPECT_NE(json.find("\"name\":\"Game::frame\",\"cat\":\"soul\",\"ph\":\"X\""), std::string::npos);
+    EXPECT_NE(json.find("\"name\":\"Scene \\\"update\\\"\""), std::string::npos);
+    EXPECT_EQ(json.find("ignored"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, DisabledProfilerRecordsNothing) {
+    profiler.setEnabled(false);
+    { SOUL_PROFILE_SCOPE("disabled"); }
+    EXPECT_TRUE(profiler.endFrame().empty());
+    profiler.setEnabled(true);
+}
@@ -0,0 +1,32 @@
+#include <gtest/gtest.h>
+#include "ringbuffer.h"
+
+using namespace soul;
+
+TEST(RingBufferTest, OverwritesOldestWhenFull) {
+    RingBuffer<int, 4> ring;
+    EXPECT_TRUE(ring.empty());
+    EXPECT_EQ(ring.capacity(), 4u);
+
+    for (int i = 1; i <= 3; ++i)
+        ring.push(i);
+    EXPECT_EQ(ring.size(), 3u);
+    EXPECT_EQ(ring[0], 1);
+    EXPECT_EQ(ring.back(), 3);
+    EXPECT_EQ(ring.offset(), 0u);
+
+    for (int i = 4; i <= 6; ++i)
+        ring.push(i);
+    EXPECT_EQ(ring.size(), 4u);
+    for (size_t i = 0; i < ring.size(); ++i)
+        EXPECT_EQ(ring[i], static_cast<int>(i) + 3);
+    EXPECT_EQ(ring.back(), 6);
+
+    // Raw layout for ImGui::PlotLines: the oldest value is at offset
+    EXPECT_EQ(ring.data()[ring.offset()], 3);
+
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+    ring.push(7);
+    EXPECT_EQ(ring[0], 7);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "schedule.h"
+#include "datetime.h"
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using namespace soul;
+
+namespace {
+
+std::vector<Date> collect(const Schedule& schedule) {
+    return std::vector<Date>(schedule.begin(), schedule.end());
+}
+
+} // namespace
+
+TEST(ScheduleTest, MonthlyClampsWithoutDrift) {
+    const Schedule schedule(Date(2024, 1, 31), Date(2024, 6, 30), Frequency::Monthly);
+
+    const std::vector<Date> expected = {Date(2024, 1, 31), Date(2024, 2, 29), Date(2024, 3, 31),
+                                        Date(2024, 4, 30), Date(2024, 5, 31), Date(2024, 6, 30)};
+    EXPECT_EQ(schedule.size(), expected.size());
+    EXPECT_EQ(collect(schedule), expected);
+
+    std::vector<Date> buffer(schedule.size());
+    EXPECT_EQ(schedule.generate(buffer), expected.size());
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST(ScheduleTest, EndOfMonthRule) {
+    // Feb 28 is the end of the month of 2023, every date is a month end with the rule
+    const Schedule rule(Date(2023, 2, 28), Date(2023, 12, 31), Frequency::Quarterly, RollConvention::Unadjusted, nullptr, true);
+    const std::vector<Date> ends = {Date(2023, 2, 28), Date(2023, 5, 31), Date(2023, 8, 31), Date(2023, 11, 30)};
+    EXPECT_EQ(collect(rule), ends);
+
+    const Schedule noRule(Date(2023, 2, 28), Date(2023, 12, 31), Frequency::Quarterly);
+    const std::vector<Date> days = {Date(2023, 2, 28), Date(2023, 5, 28), Date(2023, 8, 28), Date(2023, 11, 28)};
+    EXPECT_EQ(collect(noRule), days);
+
+    // The rule has no effect when the start is not a month end
+    const Schedule notEnd(Date(2023, 2, 27), Date(2023, 6, 1), Frequency::Quarterly, RollConvention::Unadjusted, nullptr, true);
+    EXPECT_EQ(collect(notEnd), (std::vector<Date>{Date(2023, 2, 27), Date(2023, 5, 27)}));
+
+    // Leap day with annual frequency
+    const Schedule annual(Date(2020, 2, 29), Date(2025, 3, 1), Frequency::Annual, RollConvention::Unadjusted, nullptr, true);
+    EXPECT_EQ(collect(annual), (std::vector<Date>{Date(2020, 2, 29), Date(2021, 2, 28), Date(2022, 2, 28),
+                                                  Date(2023, 2, 28), Date(2024, 2, 29), Date(2025, 2, 28)}));
+}
+
+TEST(ScheduleTest, SizeAndEndDate) {
+    EXPECT_EQ(Schedule(Date(2024, 1, 15), Date(2024, 4, 14), Frequency::Monthly).size(), 3u);
+    EXPECT_EQ(Schedule(Date(2024, 1, 15), Date(2024, 4, 15), Frequency::Monthly).size(), 4u);
+    EXPECT_EQ(Schedule(Date(2024, 1, 1), Date(2024, 1, 29), Frequency::Weekly).size(), 5u);
+    EXPECT_EQ(Schedule(Date(2024, 1, 1), Date(2023, 1, 1), Frequency::Daily).size(), 0u);
+    EXPECT_TRUE(Schedule(Date(2024, 1, 1), Date(2023, 1, 1), Frequency::Annual).empty());
+
+    // A short buffer gets the first dates
+    const Schedule schedule(Date(2024, 1, 1), Date(2024, 12, 31), Frequency::Monthly);
+    std::vector<Date> buffer(4);
+    EXPECT_EQ(schedule.generate(buffer), 4u);
+    EXPECT_EQ(buffer.back(), Date(2024, 4, 1));
+}
+
+TEST(ScheduleTest, RollConventions) {
+    HolidayCalendar holidays(2024, 2024);
+    holidays.addHoliday(2024, 4, 1);  // Easter Monday
+
+    // 2024-03-31 is a Sunday, 2024-06-30 a Sunday, 2024-09-30 a Monday, 2024-12-31 a Tuesday
+    const Schedule following(Date(2024, 3, 31), Date(2024, 12, 31), Frequency::Quarterly, RollConvention::Following, &holidays);
+    EXPECT_EQ(collect(following), (std::vector<Date>{Date(2024, 4, 2), Date(2024, 7, 1), Date(2024, 9, 30), Date(2024, 12, 31)}));
+
+    const Schedule modified(Date(2024, 3, 31), Date(2024, 12, 31), Frequency::Quarterly, RollConvention::ModifiedFollowing, &holidays);
+    EXPECT_EQ(collect(modified), (std::vector<Date>{Date(2024, 3, 29), Date(2024, 6, 28), Date(2024, 9, 30), Date(2024, 12, 31)}));
+    EXPECT_EQ(modified.unadjusted(1), Date(2024, 6, 30));
+
+    std::vector<Date> buffer(modified.size());
+    modified.generate(buffer);
+    EXPECT_EQ(buffer, collect(modified));
+}
+
+// Benchmark: one pass into a buffer against a DateTime::addMonths loop
+TEST(ScheduleTest, BenchmarkMonthlySeries) {
+    constexpr int REPEAT = 2000;
+    const Schedule schedule(Date(1990, 1, 31), Date(2089, 12, 31), Frequency::Monthly, RollConvention::ModifiedFollowing);
+    std::vector<Date> buffer(schedule.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEAT; ++r)
+        schedule.generate(buffer);
+    const std::chrono::duration<double> generated = std::chrono::steady_clock::now() - start;
+
+    const HolidayCalendar weekends;
+    std::vector<DateTime> loop;
+    start = std::chrono::steady_clock::now();
+    for (int r = 0; r < REPEAT; ++r) {
+        loop.clear();
+        DateTime date(1990, 1, 31);
+        for (size_t i = 0; i < schedule.size(); ++i) {
+            DateTime adjusted = date;
+            adjusted.roll(RollConvention::ModifiedFollowing, weekends);
+            loop.push_back(adjusted);
+            date.addMonths(1);
+        }
+    }
+    const std::chrono::duration<double> looped = std::chrono::steady_clock::now() - start;
+
+    const double dates = static_cast<double>(schedule.size()) * REPEAT;
+    std::cout << std::format("Monthly series: Schedule {:.0f} dates/s, DateTime::addMonths loop {:.0f} dates/s",
+        dates / generated.count(), dates / looped.count()) << std::endl;
+}
@@ -0,0 +1,38 @@
+#include <gtest/gtest.h>
+#include "taginterner.h"
+#include <thread>
+#include <vector>
+
+using namespace soul;
+
+TEST(TagInternerTest, SameTagSameId) {
+    TagInterner& tags = TagInterner::getInstance();
+    const TagId a = tags.intern("interner_a");
+    const TagId b = tags.intern("interner_b");
+    EXPECT_NE(a, b);
+    EXPECT_EQ(tags.intern(std::string("interner_a")), a);
+    EXPECT_EQ(tags.find("interner_b"), b);
+    EXPECT_FALSE(tags.find("interner_missing").has_value());
+    EXPECT_EQ(tags.name(a), "interner_a");
+    EXPECT_THROW(tags.name(static_cast<TagId>(tags.size())), std::out_of_range);
+}
+
+TEST(TagInternerTest, NamesKeepTheirAddress) {
+    TagInterner& tags = TagInterner::getInstance();
+    const std::string* first = &tags.name(tags.intern("interner_stable"));
+    for (int i = 0; i < 1000; ++i)
+        tags.intern("interner_" + std::to_string(i));
+    EXPECT_EQ(&tags.name(tags.intern("interner_stable")), first);
+}
+
+TEST(TagInternerTest, ConcurrentInterningGivesOneId) {
+    TagInterner& tags = TagInterner::getInstance();
+    std::vector<TagId> ids(8);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < ids.size(); ++t)
+        threads.emplace_back([&tags, &ids, t]() { ids[t] = tags.intern("interner_shared"); });
+    for (auto& thread : threads)
+        thread.join();
+    for (const TagId id : ids)
+        EXPECT_EQ(id, ids[0]);
+}
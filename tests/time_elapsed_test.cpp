@@ -19,4 +19,62 @@ TEST(TimeElapsedTest, BasicAssertions) {
     soul::st_datetime dt;
 
     std::cout << dt.year_month_day_h() << std::endl;
-}
\ No newline at end of file
+}
+
+// TscClock against steady_clock over sleeps of a few milliseconds
+TEST(TimeElapsedTest, TscClockAccuracy) {
+    static_assert(std::chrono::is_clock_v<soul::TscClock>);
+
+    std::cout << std::format("Invariant counter: {}, frequency: {:.0f} Hz", 
+        soul::TscClock::isInvariant(), soul::TscClock::frequency()) << std::endl;
+
+    for (auto sleep : {std::chrono::milliseconds(5), std::chrono::milliseconds(50)}) {
+        const auto steady0 = std::chrono::steady_clock::now();
+        const auto tsc0 = soul::TscClock::now();
+        std::this_thread::sleep_for(sleep);
+        const auto tsc1 = soul::TscClock::now();
+        const auto steady1 = std::chrono::steady_clock::now();
+
+        const double steady = std::chrono::duration<double, std::micro>(steady1 - steady0).count();
+        const double tsc = std::chrono::duration<double, std::micro>(tsc1 - tsc0).count();
+        // 1% of the interval, plus the reads themselves
+        EXPECT_NEAR(tsc, steady, steady * 0.01 + 50.0);
+    }
+
+    // Monotonic on the same thread
+    auto previous = soul::TscClock::now();
+    for (int i = 0; i < 100000; ++i) {
+        const auto now = soul::TscClock::now();
+        ASSERT_GE(now, previous);
+        previous = now;
+    }
+}
+
+TEST(TimeElapsedTest, ElapsedOnTscClock) {
+    soul::st_time_elapsed<soul::TscClock> tp;
+    tp.start();
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_GE(tp.elapsed(), std::chrono::milliseconds(9));
+    EXPECT_LT(tp.elapsed(), std::chrono::milliseconds(500));
+}
+
+// Cost of a read, steady_clock against TscClock
+TEST(TimeElapsedTest, BenchmarkClockReads) {
+    constexpr int READS = 1000000;
+    soul::TscClock::now();
+
+    auto start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::rep steadySum = 0;
+    for (int i = 0; i < READS; ++i)
+        steadySum += std::chrono::steady_clock::now().time_since_epoch().count();
+    const double steadyNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / READS;
+
+    start = std::chrono::steady_clock::now();
+    soul::TscClock::rep tscSum = 0;
+    for (int i = 0; i < READS; ++i)
+        tscSum += soul::TscClock::now().time_since_epoch().count();
+    const double tscNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / READS;
+
+    EXPECT_NE(steadySum + tscSum, 0);
+    std::cout << std::format("Clock read: steady_clock {:.1f} ns, TscClock {:.1f} ns", steadyNs, tscNs) << std::endl;
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include "world.h"
+#include "systems.h"
+#include "entity.h"
+#include "time_elapsed.h"
+#include <format>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace soul::ecs;
+
+TEST(WorldTest, CreateAndGetComponents) {
+    World world;
+    const EntityId a = world.create(Transform {1.0f, 2.0f}, Velocity {3.0f, 4.0f});
+    const EntityId b = world.create(Transform {5.0f, 6.0f});
+
+    EXPECT_EQ(world.size(), 2u);
+    EXPECT_EQ(world.getCountArchetypes(), 2u);
+    ASSERT_NE(world.get<Transform>(a), nullptr);
+    EXPECT_EQ(world.get<Transform>(a)->y, 2.0f);
+    EXPECT_EQ(world.get<Velocity>(a)->dx, 3.0f);
+    EXPECT_EQ(world.get<Velocity>(b), nullptr);
+    EXPECT_TRUE(world.has<Transform>(b));
+    EXPECT_EQ(world.count<Transform>(), 2u);
+    EXPECT_EQ((world.count<Transform, Velocity>()), 1u);
+}
+
+TEST(WorldTest, DestroyedHandlesAreStale) {
+    World world;
+    const EntityId a = world.create(Lifetime {1.0f});
+    world.destroy(a);
+    EXPECT_FALSE(world.isAlive(a));
+    EXPECT_EQ(world.get<Lifetime>(a), nullptr);
+
+    // The slot is reused with a new generation
+    const EntityId b = world.create(Lifetime {2.0f});
+    EXPECT_EQ(b.index, a.index);
+    EXPECT_NE(b.generation, a.generation);
+    world.destroy(a);
+    EXPECT_TRUE(world.isAlive(b));
+    EXPECT_EQ(world.get<Lifetime>(b)->remaining, 2.0f);
+}
+
+TEST(WorldTest, RemovalKeepsRowsDense) {
+    World world;
+    std::vector<EntityId> ids;
+    for (int i = 0; i < 1000; ++i)
+        ids.push_back(world.create(Transform {static_cast<float>(i)}));
+
+    // Every other entity, each removal moves the last row into the hole
+    for (int i = 0; i < 1000; i += 2)
+        world.destroy(ids[i]);
+
+    EXPECT_EQ(world.size(), 500u);
+    for (int i = 1; i < 1000; i += 2)
+        EXPECT_EQ(world.get<Transform>(ids[i])->x, static_cast<float>(i));
+
+    size_t visited = 0;
+    world.forEachChunk<Transform>([&](size_t count, const EntityId* entities, Transform* transforms) {
+        for (size_t i = 0; i < count; ++i) {
+            EXPECT_EQ(world.get<Transform>(entities[i]), &transforms[i]);
+            ++visited;
+        }
+    });
+    EXPECT_EQ(visited, 500u);
+}
+
+TEST(WorldTest, AddAndRemoveMoveBetweenArchetypes) {
+    World world;
+    const EntityId a = world.create(Transform {1.0f, 1.0f});
+    const EntityId b = world.create(Transform {2.0f, 2.0f});
+
+    world.add(a, Velocity {10.0f, 0.0f});
+    EXPECT_EQ(world.get<Transform>(a)->x, 1.0f);
+    EXPECT_EQ(world.get<Velocity>(a)->dx, 10.0f);
+    EXPECT_EQ(world.get<Transform>(b)->x, 2.0f);
+    EXPECT_EQ(world.count<Velocity>(), 1u);
+
+    world.remove<Velocity>(a);
+    EXPECT_FALSE(world.has<Velocity>(a));
+    EXPECT_EQ(world.get<Transform>(a)->x, 1.0f);
+
+    // Without any component left the entity is gone
+    world.remove<Transform>(b);
+    EXPECT_FALSE(world.isAlive(b));
+    EXPECT_EQ(world.size(), 1u);
+}
+
+TEST(WorldTest, SystemsUpdateAndExpire) {
+    World world;
+    const EntityId moving = world.create(Transform {0.0f, 0.0f}, Velocity {100.0f, -50.0f});
+    const EntityId animated = world.create(Sprite {1, 0.0f, 0.0f, 32.0f, 48.0f}, Animation {64.0f, 0.1f, 0.0f, 0, 4});
+    const EntityId shortLived = world.create(Transform {}, Lifetime {0.3f});
+
+    update(world, 0.25f);
+    EXPECT_FLOAT_EQ(world.get<Transform>(moving)->x, 25.0f);
+    EXPECT_FLOAT_EQ(world.get<Transform>(moving)->y, -12.5f);
+    EXPECT_EQ(world.get<Animation>(animated)->frame, 2);
+    EXPECT_FLOAT_EQ(world.get<Sprite>(animated)->u, 64.0f + 2 * 32.0f);
+    EXPECT_TRUE(world.isAlive(shortLived));
+
+    update(world, 0.25f);
+    // 5 frames in 0.5 s, wrapped on 4 frames
+    EXPECT_EQ(world.get<Animation>(animated)->frame, 1);
+    EXPECT_FALSE(world.isAlive(shortLived));
+    EXPECT_EQ(world.size(), 2u);
+}
+
+namespace {
+
+// The polymorphic layout of the EntityManager, for comparison
+class MovingEntity : public soul::Entity {
+public:
+    MovingEntity(float x, float dx) : Entity("moving"), _x(x), _dx(dx) {}
+    bool update(float dt) override {
+        _x += _dx * dt;
+        _elapsed += dt;
+        if (_elapsed >= 0.1f) {
+            _elapsed -= 0.1f;
+            _frame = (_frame + 1) % 8;
+        }
+        return isActive();
+    }
+private:
+    float _x, _y {0.0f}, _dx, _dy {1.0f}, _elapsed {0.0f};
+    uint16_t _frame {0};
+};
+
+} // namespace
+
+TEST(WorldTest, BenchmarkAnimatedEntities) {
+    constexpr int COUNT = 100000;
+    constexpr int FRAMES = 100;
+    constexpr float DT = 1.0f / 60.0f;
+
+    World world;
+    for (int i = 0; i < COUNT; ++i) {
+        world.create(Transform {static_cast<float>(i), 0.0f}, Velocity {1.0f, 1.0f},
+            Sprite {0, 0.0f, 0.0f, 32.0f, 32.0f}, Animation {0.0f, 0.1f, 0.0f, 0, 8});
+    }
+
+    soul::st_time_elapsed<> elapsed;
+    elapsed.start();
+    for (int frame = 0; frame < FRAMES; ++frame)
+        update(world, DT);
+    const double ecsMs = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count() / FRAMES;
+
+    std::vector<std::shared_ptr<soul::Entity>> entities;
+    entities.reserve(COUNT);
+    for (int i = 0; i < COUNT; ++i)
+        entities.push_back(std::make_shared<MovingEntity>(static_cast<float>(i), 1.0f));
+
+    elapsed.start();
+    size_t active = 0;
+    for (int frame = 0; frame < FRAMES; ++frame) {
+        for (auto& entity : entities)
+            active += entity->update(DT);
+    }
+    const double virtualMs = std::chrono::duration<double, std::milli>(elapsed.elapsed()).count() / FRAMES;
+
+    EXPECT_EQ(world.size(), static_cast<size_t>(COUNT));
+    EXPECT_EQ(active, static_cast<size_t>(COUNT) * FRAMES);
+    std::cout << std::format("{} animated entities: archetype ECS {:.3f} ms/frame, virtual update {:.3f} ms/frame\n",
+        COUNT, ecsMs, virtualMs);
+}